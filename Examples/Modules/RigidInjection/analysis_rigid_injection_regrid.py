@@ -0,0 +1,75 @@
+#! /usr/bin/env python
+
+# Copyright 2021
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+
+'''
+Analysis script of a WarpX simulation of rigid injection with dynamic
+regridding.
+
+The input file inputs_2d_LabFrame is used, with one level of mesh
+refinement that follows the beam (warpx.regrid_int and
+warpx.tag_particles_per_cell): the refined level is created by the regrid,
+after the initialization of the species. As in RigidInjection_lab, the beam
+propagates rigidly up to 20 microns and then expands due to emittance only.
+The beam width is compared with the theory (with a 5% error allowed).
+'''
+
+import sys
+import yt
+import numpy as np
+yt.funcs.mylog.setLevel(0)
+
+filename = sys.argv[1]
+
+# WarpX headers include more data when rigid injection is used (number of
+# levels, then position of the injection plane and injection flag for each
+# level), which gives an error with the last yt release. These lines are
+# removed if needed.
+def remove_rigid_lines(plotfile):
+    header_name = plotfile + '/WarpXHeader'
+    with open(header_name, 'r') as f:
+        file_lines = f.readlines()
+    for nlevs in range(1, 10):
+        nlines_rigid = 2*nlevs + 1
+        if len(file_lines) > nlines_rigid and \
+           file_lines[-nlines_rigid].strip() == str(nlevs):
+            with open(header_name, 'w') as f:
+                f.writelines(file_lines[:-nlines_rigid])
+            return nlevs
+    return 0
+
+# Remove rigid injection header lines, and check that the injection
+# plane is defined for each level
+nlevs = remove_rigid_lines(filename)
+ds = yt.load( filename )
+assert nlevs == ds.max_level + 1
+assert ds.max_level == 1
+
+ad = ds.all_data()
+# Beam longitudinal position
+z = np.mean(ad['beam', 'particle_position_y'].v)
+# Beam width
+w = np.std(ad['beam', 'particle_position_x'].v)
+
+# initial parameters
+z0 = 20.e-6
+w0 = 1.e-6
+theta0 = np.arcsin(0.1)
+
+# Theoretical beam width after propagation
+wth = np.sqrt( w0**2 + (z-z0)**2*theta0**2 )
+error_rel = np.abs((w-wth)/wth)
+tolerance_rel = 0.05
+
+print("Beam position: " + str(z))
+print("Beam width   : " + str(w))
+
+print("error_rel    : " + str(error_rel))
+print("tolerance_rel: " + str(tolerance_rel))
+
+assert( error_rel < tolerance_rel )
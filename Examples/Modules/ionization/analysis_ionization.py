@@ -16,8 +16,13 @@ respectively): a plane-wave laser pulse propagates through a
 uniform N2+ neutral plasma and further ionizes the Nitrogen atoms. This test
 checks that, after the laser went through the plasma, ~32% of Nitrogen
 ions are N5+, in agreement with theory from Chen's article.
+
+In the lab frame, the particle tiles whose occupancy falls below 50% are also
+shrunk (particles.min_tile_occupancy), and this test checks the columns of the
+ParticleMemory reduced diagnostic.
 """
 
+import re
 import sys
 import yt
 import numpy as np
@@ -90,5 +95,27 @@ print("tolerance_rel: " + str(tolerance_rel))
 
 assert( error_rel < tolerance_rel )
 
+if re.search( 'ionization_lab', filename ):
+    # Columns: step, time, live memory (total, electrons, ions),
+    # allocated memory (total, electrons, ions)
+    with open("./diags/reducedfiles/particle_memory.txt") as f:
+        header = f.readline()
+    for column in ["[3]total live memory(B)", "[4]electrons live memory(B)",
+                   "[5]ions live memory(B)", "[6]total allocated memory(B)",
+                   "[7]electrons allocated memory(B)", "[8]ions allocated memory(B)"]:
+        assert column in header
+    data = np.genfromtxt("./diags/reducedfiles/particle_memory.txt")
+    assert data.shape[1] == 8
+    live = data[:,2:5]
+    allocated = data[:,5:8]
+    assert np.allclose( live[:,0], live[:,1] + live[:,2], rtol=1.e-12 )
+    assert np.allclose( allocated[:,0], allocated[:,1] + allocated[:,2], rtol=1.e-12 )
+    assert np.all( live[:,2] > 0 )
+    assert np.all( live <= allocated )
+    # With particles.min_tile_occupancy = 0.5, no tile is less than half full
+    # after the redistribution of the particles
+    print("max allocated/live memory: " + str(np.max(allocated[:,0]/live[:,0])))
+    assert np.all( allocated <= 2.05*live )
+
 test_name = filename[:-9] # Could also be os.path.split(os.getcwd())[1]
 checksumAPI.evaluate_checksum(test_name, filename)
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+
+# Copyright 2021
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+
+# This file is part of the WarpX automated test suite. It is used to test the
+# plugins loaded at runtime with warpx.plugins.
+#
+# - Compile example_plugin.cpp as a shared library, and run a short Langmuir
+#   simulation that loads it: check that the hooks are called once per step
+#   (and AfterInit once).
+# - Check that WarpX aborts with an explicit message when the library does not
+#   exist, or does not export the factory function warpx_plugin_create.
+
+import glob
+import re
+import subprocess
+
+max_step = 10
+
+def run(args):
+    """ Run the command args, and return its exit code and its output """
+    print(' '.join(args))
+    p = subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                       universal_newlines=True)
+    print(p.stdout)
+    return p.returncode, p.stdout
+
+def compile_library(source, library):
+    code, _ = run(['c++', '-std=c++14', '-shared', '-fPIC', '-I.', source, '-o', library])
+    assert code == 0
+
+def main():
+    executables = glob.glob("main2d*")
+    assert len(executables) == 1
+    exe = "./" + executables[0]
+    base_args = [exe, "inputs_2d_multi_rt", "max_step=%d" %max_step]
+
+    # Plugin that counts the calls of the hooks
+    compile_library("example_plugin.cpp", "libexample_plugin.so")
+    code, output = run(base_args + ["warpx.plugins=./libexample_plugin.so"])
+    assert code == 0
+    assert "Loaded plugin ./libexample_plugin.so" in output
+    counts = re.search(r"ExamplePlugin: AfterInit (\d+) BeforeStep (\d+) AfterStep (\d+) "
+                       r"BeforeDeposition (\d+)", output)
+    assert counts is not None
+    assert [int(n) for n in counts.groups()] == [1, max_step, max_step, max_step]
+
+    # Missing library
+    code, output = run(base_args + ["warpx.plugins=./libmissing_plugin.so"])
+    assert code != 0
+    assert "warpx.plugins: cannot load ./libmissing_plugin.so" in output
+
+    # Library without the factory function
+    with open("no_factory.cpp", "w") as f:
+        f.write("int warpx_not_a_plugin = 0;\n")
+    compile_library("no_factory.cpp", "libno_factory.so")
+    code, output = run(base_args + ["warpx.plugins=./libno_factory.so"])
+    assert code != 0
+    assert "does not export warpx_plugin_create" in output
+
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,47 @@
+/* Copyright 2021
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+/* Minimal WarpX plugin, loaded at runtime with `warpx.plugins`: it counts the
+ * calls of some of the hooks, and prints them when it is destroyed.
+ *
+ * This example only needs the header Source/Utils/WarpXPlugin.H:
+ *
+ *     c++ -std=c++14 -shared -fPIC -I<WarpX>/Source/Utils example_plugin.cpp \
+ *         -o libexample_plugin.so
+ *
+ * Plugins that access the fields and particles (through the WarpX instance)
+ * also need the include directories of WarpX and AMReX, and must be compiled
+ * with the same options (e.g. dimensionality, precision) as WarpX.
+ */
+#include "WarpXPlugin.H"
+
+#include <iostream>
+
+class ExamplePlugin : public WarpXPlugin
+{
+public:
+    ~ExamplePlugin () override
+    {
+        std::cout << "ExamplePlugin: AfterInit " << m_after_init
+                  << " BeforeStep " << m_before_step
+                  << " AfterStep " << m_after_step
+                  << " BeforeDeposition " << m_before_deposition << std::endl;
+    }
+
+    void AfterInit (WarpX& /*warpx*/) override { ++m_after_init; }
+    void BeforeStep (WarpX& /*warpx*/) override { ++m_before_step; }
+    void AfterStep (WarpX& /*warpx*/) override { ++m_after_step; }
+    void BeforeDeposition (WarpX& /*warpx*/) override { ++m_before_deposition; }
+
+private:
+    int m_after_init = 0;
+    int m_before_step = 0;
+    int m_after_step = 0;
+    int m_before_deposition = 0;
+};
+
+extern "C" WarpXPlugin* warpx_plugin_create () { return new ExamplePlugin(); }
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+
+# Copyright 2021
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+
+# This file is part of the WarpX automated test suite. It is used to test the
+# initialization of a plasma whose density and momentum are tabulated in an
+# openPMD file (<species>.profile = read_from_file and
+# <species>.momentum_distribution_type = read_from_file).
+#
+# - Generate an openPMD file with a density table along x and z, and a momentum
+#   table along z.
+# - Run the WarpX simulation, which only writes the initial particles.
+# - Compare the weight and the momentum of each particle with the tabulated
+#   profiles at its position: the profiles are bilinear and linear, which the
+#   interpolation of the tables reproduces exactly.
+
+import glob
+import os
+import numpy as np
+import openpmd_api as io
+import yt ; yt.funcs.mylog.setLevel(50)
+from scipy.constants import c, m_e
+
+# Domain and particles per cell (see inputs_2d)
+xmin = -16.e-6
+xmax = 16.e-6
+zmin = 0.
+zmax = 32.e-6
+nx = 32
+nz = 32
+ppc = 4
+dx = (xmax - xmin)/nx
+dz = (zmax - zmin)/nz
+
+# Tabulated profiles
+n0 = 1.e24
+
+def density(x, z):
+    return n0*(1. + 0.5*x/xmax)*(0.5 + z/zmax)
+
+def momentum(z):
+    return 0.01*z/zmax, np.zeros_like(z), 0.1*(1. - z/zmax)
+
+def write_file(fname):
+    """ Write the density (mesh record `density`, along z and x) and the
+    momentum (mesh record `u`, along z) tables in the openPMD file fname
+    """
+    # The tables cover the domain, with a node on each edge
+    x = np.linspace(xmin, xmax, nx+1)
+    z = np.linspace(zmin, zmax, nz+1)
+
+    series = io.Series(fname, io.Access.create)
+    it = series.iterations[0]
+
+    # Density: the last axis (x) varies fastest
+    Z, X = np.meshgrid(z, x, indexing='ij')
+    rho_data = np.ascontiguousarray(density(X, Z))
+    rho = it.meshes["density"]
+    rho.axis_labels = ["z", "x"]
+    rho.grid_spacing = [dz, dx]
+    rho.grid_global_offset = [zmin, xmin]
+    rho.grid_unit_SI = 1.
+    rho_comp = rho[io.Mesh_Record_Component.SCALAR]
+    rho_comp.position = [0., 0.]
+    rho_comp.unit_SI = 1.
+    rho_comp.reset_dataset(io.Dataset(rho_data.dtype, rho_data.shape))
+    rho_comp.store_chunk(rho_data)
+
+    # Momentum
+    u = it.meshes["u"]
+    u.axis_labels = ["z"]
+    u.grid_spacing = [dz]
+    u.grid_global_offset = [zmin]
+    u.grid_unit_SI = 1.
+    for name, u_data in zip(["x", "y", "z"], momentum(z)):
+        u_data = np.ascontiguousarray(u_data)
+        u_comp = u[name]
+        u_comp.position = [0.]
+        u_comp.unit_SI = 1.
+        u_comp.reset_dataset(io.Dataset(u_data.dtype, u_data.shape))
+        u_comp.store_chunk(u_data)
+
+    series.flush()
+    del series
+
+def do_analysis(fname):
+    ds = yt.load(fname)
+    ad = ds.all_data()
+    x = ad['electrons', 'particle_position_x'].to_ndarray()
+    z = ad['electrons', 'particle_position_y'].to_ndarray()
+    w = ad['electrons', 'particle_weight'].to_ndarray()
+    assert x.shape[0] == nx*nz*ppc
+
+    w_th = density(x, z)*dx*dz/ppc
+    error_w = np.amax(np.abs(w - w_th)/w_th)
+    print("Relative error weight: ", error_w)
+    assert error_w < 1.e-10
+
+    for u_th, comp in zip(momentum(z), ['x', 'y', 'z']):
+        u = ad['electrons', 'particle_momentum_'+comp].to_ndarray()/(m_e*c)
+        error_u = np.amax(np.abs(u - u_th))/0.1
+        print("Error u" + comp + ": ", error_u)
+        assert error_u < 1.e-10
+
+def main():
+    executables = glob.glob("main2d*")
+    assert len(executables) == 1
+    write_file("profile_from_file.h5")
+    os.system("./" + executables[0] + " inputs_2d diag1.file_prefix=diags/plotfiles/plt")
+    do_analysis(sorted(glob.glob("diags/plotfiles/plt*"))[-1])
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
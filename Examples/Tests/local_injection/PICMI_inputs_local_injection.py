@@ -0,0 +1,124 @@
+# Test of the particle injection with add_particles(local=True).
+# At every step, each process injects a few particles inside each of the
+# boxes that it owns. The script checks that no particle is lost or
+# duplicated and, when run with the argument --mr, that the particles
+# injected inside the refined patch end up on level 1.
+
+import sys
+import numpy as np
+from mpi4py import MPI as mpi
+from pywarpx import picmi, callbacks
+
+comm = mpi.COMM_WORLD
+
+do_mr = '--mr' in sys.argv
+
+nx = 64
+nz = 64
+
+xmin = -32.e-6
+xmax = +32.e-6
+zmin = -32.e-6
+zmax = +32.e-6
+
+# Lower and upper bound of the refined patch, aligned with the blocking factor
+patch_lo = [-16.e-6, -16.e-6]
+patch_hi = [+16.e-6, +16.e-6]
+
+max_steps = 4
+
+grid = picmi.Cartesian2DGrid(number_of_cells = [nx, nz],
+                             lower_bound = [xmin, zmin],
+                             upper_bound = [xmax, zmax],
+                             lower_boundary_conditions = ['periodic', 'periodic'],
+                             upper_boundary_conditions = ['periodic', 'periodic'],
+                             warpx_max_grid_size = 16,
+                             warpx_blocking_factor = 8)
+
+if do_mr:
+    grid.add_refined_region(level = 1, lo = patch_lo, hi = patch_hi)
+
+solver = picmi.ElectromagneticSolver(grid = grid, cfl = 0.99)
+
+# --- No initial distribution: all the particles are added from Python
+electrons = picmi.Species(particle_type = 'electron', name = 'electrons')
+
+sim = picmi.Simulation(solver = solver,
+                       max_steps = max_steps,
+                       verbose = 1)
+
+sim.add_species(electrons, layout = None)
+
+
+# Below is WarpX specific code to inject and check the particles.
+import pywarpx
+wx = pywarpx._libwarpx
+
+dx = (xmax - xmin)/nx
+dz = (zmax - zmin)/nz
+
+# Positions of the particles injected in each box, in units of the box size
+box_fractions = [(0.25, 0.25), (0.75, 0.25), (0.25, 0.75), (0.75, 0.75)]
+
+n_injected = 0
+n_injected_in_patch = 0
+
+def local_positions():
+    """Return the positions of the particles to inject in the boxes of
+    level 0 owned by this process."""
+    lovects, _ = wx.get_mesh_electric_field_lovects(0, 0, include_ghosts=False)
+    fabs = wx.get_mesh_electric_field(0, 0, include_ghosts=False)
+    nodal_flag = wx.get_Ex_nodal_flag()
+    x = []
+    z = []
+    for i, fab in enumerate(fabs):
+        ncells = np.array(fab.shape[:2]) - nodal_flag
+        for fx, fz in box_fractions:
+            x.append(xmin + (lovects[0,i] + fx*ncells[0])*dx)
+            z.append(zmin + (lovects[1,i] + fz*ncells[1])*dz)
+    return np.array(x), np.array(z)
+
+def inject():
+    global n_injected, n_injected_in_patch
+    x, z = local_positions()
+    wx.add_particles(electrons.species_number, x = x, y = 0., z = z,
+                     ux = 0., uy = 0., uz = 0., attr = 1.,
+                     unique_particles = True, local = True)
+    in_patch = ((patch_lo[0] < x) & (x < patch_hi[0]) &
+                (patch_lo[1] < z) & (z < patch_hi[1]))
+    n_injected += len(x)
+    n_injected_in_patch += np.count_nonzero(in_patch)
+
+callbacks.installparticleinjection(inject)
+
+sim.step()
+
+# --- Gather the particle counts and ids over all the levels and processes
+n_levels = wx.libwarpx.warpx_finestLevel() + 1
+counts = []
+ids = []
+for lev in range(n_levels):
+    counts.append(sum(len(xs) for xs in wx.get_particle_x(electrons.species_number, lev)))
+    ids.extend(wx.get_particle_id(electrons.species_number, lev))
+
+n_injected = comm.allreduce(n_injected)
+n_injected_in_patch = comm.allreduce(n_injected_in_patch)
+counts = [comm.allreduce(count) for count in counts]
+local_ids = np.concatenate(ids) if ids else np.array([], dtype=int)
+ids = np.concatenate(comm.allgather(local_ids))
+
+print('injected: %d, in the patch: %d, per level: %s'
+      %(n_injected, n_injected_in_patch, counts))
+
+assert n_injected == max_steps*len(box_fractions)*(nx//16)*(nz//16)
+assert sum(counts) == n_injected
+assert len(np.unique(ids)) == n_injected
+if do_mr:
+    assert n_levels == 2
+    assert n_injected_in_patch > 0
+    assert counts[1] == n_injected_in_patch
+else:
+    assert n_levels == 1
+
+if comm.rank == 0:
+    print('Passed')
@@ -0,0 +1,48 @@
+#! /usr/bin/env python
+
+# Copyright 2021
+#
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script tests the single-precision guard cell communications
+(warpx.do_single_precision_comms=1) with non-periodic boundaries,
+PML and mesh refinement.
+
+The input file inputs_mr_2d is used: a positive and a negative particle
+leave the box through the PML. The guard cells that are not filled by the
+communications (at the edges of the domain, next to the PML and at the edges
+of the fine patch) must keep their values: this script checks that all the
+fields are finite and that the field in the box is close to 0 once the
+particles have left, with the same tolerance as in full precision.
+"""
+import sys
+import numpy as np
+import yt
+yt.funcs.mylog.setLevel(0)
+
+# Open plotfile specified in command line
+filename = sys.argv[1]
+ds = yt.load( filename )
+
+for lev in range(ds.max_level+1):
+    grids = [ g for g in ds.index.grids if g.Level == lev ]
+    for field in ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz']:
+        for g in grids:
+            assert np.all(np.isfinite(g[field].to_ndarray())), \
+                "Non-finite values in %s on level %d" %(field, lev)
+
+# Check that the field is low enough
+ad0 = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+Ex_array = ad0['Ex'].to_ndarray()
+Ey_array = ad0['Ey'].to_ndarray()
+Ez_array = ad0['Ez'].to_ndarray()
+max_Efield = max(Ex_array.max(), Ey_array.max(), Ez_array.max())
+print( "max_Efield = %s" %max_Efield )
+
+tolerance_abs = 0.0006
+print("tolerance_abs: " + str(tolerance_abs))
+assert max_Efield < tolerance_abs
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+
+# Copyright 2021
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+
+# This file is part of the WarpX automated test suite. It is used to test the
+# restart from a checkpoint with a different domain decomposition
+# (amr.regrid_on_restart = 1).
+#
+# - Run the simulation of `inputs` without interruption (checkpoint at step 5).
+# - Restart it from step 5 with a smaller amr.max_grid_size, so that the fields
+#   and particles of the checkpoint are redistributed on the new grids.
+# - Compare the final particles and fields of both runs: only the order of the
+#   floating-point operations differs, e.g. in the deposition.
+
+import glob
+import os
+import numpy as np
+import yt ; yt.funcs.mylog.setLevel(50)
+
+def load(fname):
+    ds = yt.load(fname)
+    ad = ds.all_data()
+    grid = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+    return ds, ad, grid
+
+def do_analysis(fname_orig, fname_restart):
+    ds0, ad0, grid0 = load(fname_orig)
+    ds, ad, grid = load(fname_restart)
+    assert ds.index.num_grids > ds0.index.num_grids
+
+    # Particles: compare the sorted positions (the order of the particles differs)
+    length = (ds0.domain_right_edge - ds0.domain_left_edge).to_ndarray()
+    for species in ['beam', 'plasma_e']:
+        for idim, comp in enumerate(['x', 'y', 'z']):
+            r0 = np.sort(ad0[species, 'particle_position_'+comp].to_ndarray())
+            r = np.sort(ad[species, 'particle_position_'+comp].to_ndarray())
+            assert r.shape == r0.shape, "Different number of %s particles" %species
+            error = np.amax(np.abs(r - r0))/length[idim]
+            print("%s, position %s: relative error %g" %(species, comp, error))
+            assert error < 1.e-12
+
+    # Fields
+    for field in ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz']:
+        F0 = grid0['boxlib', field].to_ndarray()
+        F = grid['boxlib', field].to_ndarray()
+        error = np.amax(np.abs(F - F0))/np.amax(np.abs(F0))
+        print("%s: relative error %g" %(field, error))
+        assert error < 1.e-9
+
+def main():
+    executables = glob.glob("main3d*")
+    assert len(executables) == 1
+    exe = "./" + executables[0]
+    os.system(exe + " inputs chk.file_prefix=orig_chk diag1.file_prefix=orig_plt")
+    os.system(exe + " inputs amr.restart=orig_chk00005 amr.regrid_on_restart=1 amr.max_grid_size=32"
+              + " chk.file_prefix=restart_chk diag1.file_prefix=restart_plt")
+    do_analysis("orig_plt00010", "restart_plt00010")
+    print('Passed')
+
+if __name__ == "__main__":
+    main()
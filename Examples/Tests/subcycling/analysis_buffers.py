@@ -0,0 +1,43 @@
+#! /usr/bin/env python
+
+# Copyright 2021
+#
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the partition of the particles between the fine patch and
+the deposition/gather buffers (inputs_2d with warpx.n_current_deposition_buffer
+and warpx.n_field_gather_buffer of different sizes).
+
+With buffers of different sizes, the particles of each tile are partitioned
+twice at each step (fine patch / larger buffer, then larger buffer / smaller
+buffer), in place. This script checks that the fields are finite on all the
+levels, and that this reordering neither loses nor duplicates particles: the
+number of macroparticles of the beams is conserved and their ids are unique.
+"""
+import sys
+import numpy as np
+import yt
+yt.funcs.mylog.setLevel(0)
+
+# Open plotfile specified in command line
+filename = sys.argv[1]
+ds = yt.load( filename )
+
+assert ds.max_level >= 1
+
+for g in ds.index.grids:
+    for field in ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz']:
+        assert np.all(np.isfinite(g[field].to_ndarray())), \
+            "Non-finite values in %s on level %d" %(field, g.Level)
+
+ad = ds.all_data()
+for species in ['driver', 'beam']:
+    npart = ad[species, 'particle_weight'].shape[0]
+    ids = ad[species, 'particle_id'].to_ndarray()
+    print( "%s: %d macroparticles" %(species, npart) )
+    assert npart == 10000
+    assert np.unique(ids).shape[0] == npart, "Duplicated %s particles" %species
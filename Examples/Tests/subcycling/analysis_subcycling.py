@@ -0,0 +1,40 @@
+#! /usr/bin/env python
+
+# Copyright 2021
+#
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the sub-cycling with more than 2 levels or with a
+refinement ratio larger than 2 (inputs_2d with amr.max_level=2 or
+amr.ref_ratio=4).
+
+In these cases, the finer levels perform intermediate substeps, which must
+neither split the particles nor skip any part of the field push. This script
+checks that the fields are finite on all the levels, and that the number of
+macroparticles of the beams is conserved.
+"""
+import sys
+import numpy as np
+import yt
+yt.funcs.mylog.setLevel(0)
+
+# Open plotfile specified in command line
+filename = sys.argv[1]
+ds = yt.load( filename )
+
+assert ds.max_level >= 1
+
+for g in ds.index.grids:
+    for field in ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz']:
+        assert np.all(np.isfinite(g[field].to_ndarray())), \
+            "Non-finite values in %s on level %d" %(field, g.Level)
+
+ad = ds.all_data()
+for species in ['driver', 'beam']:
+    npart = ad[species, 'particle_weight'].shape[0]
+    print( "%s: %d macroparticles" %(species, npart) )
+    assert npart == 10000
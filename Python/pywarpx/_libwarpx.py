@@ -197,7 +197,7 @@ libwarpx.warpx_addNParticles.argtypes = (ctypes.c_int, ctypes.c_int,
                                          _ndpointer(c_particlereal, flags="C_CONTIGUOUS"),
                                          ctypes.c_int,
                                          _ndpointer(c_particlereal, flags="C_CONTIGUOUS"),
-                                         ctypes.c_int)
+                                         ctypes.c_int, ctypes.c_int)
 
 libwarpx.warpx_getProbLo.restype = c_real
 libwarpx.warpx_getProbHi.restype = c_real
@@ -348,7 +348,7 @@ def getCellSize(direction, level=0):
 
 def add_particles(species_number=0,
                   x=0., y=0., z=0., ux=0., uy=0., uz=0., attr=0.,
-                  unique_particles=True):
+                  unique_particles=True, local=False):
     '''
 
     A function for adding particles to the WarpX simulation.
@@ -362,6 +362,15 @@ def add_particles(species_number=0,
     attr             : a 2D numpy array or scalar with the particle attributes (default = 0.)
     unique_particles : whether the particles are unique or duplicated on
                        several processes. (default = True)
+    local            : whether each particle is located either in a box owned
+                       by this process, or in a box of another process that is
+                       within one cell of these boxes. Only a local
+                       redistribution of the particles, with these neighbouring
+                       processes, is then done, which is cheaper when particles
+                       are injected at every step; particles further away are
+                       not handled. With mesh refinement, the global
+                       redistribution is always done. Requires
+                       unique_particles. (default = False)
 
     '''
 
@@ -405,7 +414,7 @@ def add_particles(species_number=0,
 
     libwarpx.warpx_addNParticles(species_number, x.size,
                                  x, y, z, ux, uy, uz,
-                                 attr.shape[-1], attr, unique_particles)
+                                 attr.shape[-1], attr, unique_particles, local)
 
 def get_particle_structs(species_number, level):
     '''
@@ -440,8 +449,6 @@ def get_particle_structs(species_number, level):
         arr = _array1d_from_pointer(data[i], _p_dtype, particles_per_tile[i])
         particle_data.append(arr)
 
-    _libc.free(particles_per_tile)
-    _libc.free(data)
     return particle_data
 
 
@@ -483,8 +490,6 @@ def get_particle_arrays(species_number, comp, level):
             pass
         particle_data.append(arr)
 
-    _libc.free(particles_per_tile)
-    _libc.free(data)
     return particle_data
 
 
@@ -628,10 +633,25 @@ def get_particle_theta(species_number, level=0):
         raise Exception('get_particle_r: There is no theta coordinate with 2D Cartesian')
 
 
+# --- Cache of the lists of field data arrays. The arrays share the memory of WarpX,
+# --- so they can be reused until the fields are reallocated (e.g. when regridding),
+# --- which is tracked by warpx_getFieldsVersion.
+_mesh_field_cache = {}
+_mesh_field_cache_version = None
+
 def _get_mesh_field_list(warpx_func, level, direction, include_ghosts):
     """
      Generic routine to fetch the list of field data arrays.
     """
+    global _mesh_field_cache_version
+    fields_version = libwarpx.warpx_getFieldsVersion()
+    if fields_version != _mesh_field_cache_version:
+        _mesh_field_cache.clear()
+        _mesh_field_cache_version = fields_version
+    key = (warpx_func.__name__, level, direction, include_ghosts)
+    if key in _mesh_field_cache:
+        return list(_mesh_field_cache[key])
+
     shapes = _LP_c_int()
     size = ctypes.c_int(0)
     ncomps = ctypes.c_int(0)
@@ -663,9 +683,8 @@ def _get_mesh_field_list(warpx_func, level, direction, include_ghosts):
         else:
             grid_data.append(arr[tuple([slice(ngvect[d], -ngvect[d]) for d in range(dim)])])
 
-    _libc.free(shapes)
-    _libc.free(data)
-    return grid_data
+    _mesh_field_cache[key] = grid_data
+    return list(grid_data)
 
 
 def get_mesh_electric_field(level, direction, include_ghosts=True):
@@ -1168,7 +1187,6 @@ def _get_mesh_array_lovects(level, direction, include_ghosts=True, getlovectsfun
             lovects[d,:] += ngrowvect[d]
 
     del lovects_ref
-    _libc.free(data)
     return lovects, ng
 
 
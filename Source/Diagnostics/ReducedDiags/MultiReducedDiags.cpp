@@ -15,6 +15,7 @@
 #include "FieldMaximum.H"
 #include "RhoMaximum.H"
 #include "ParticleNumber.H"
+#include "ParticleMemory.H"
 #include "MultiReducedDiags.H"
 
 #include <AMReX_ParmParse.H>
@@ -94,6 +95,11 @@ MultiReducedDiags::MultiReducedDiags ()
             m_multi_rd[i_rd]=
                 std::make_unique<ParticleNumber>(m_rd_names[i_rd]);
         }
+        else if (rd_type.compare("ParticleMemory") == 0)
+        {
+            m_multi_rd[i_rd]=
+                std::make_unique<ParticleMemory>(m_rd_names[i_rd]);
+        }
         else if (rd_type.compare("ParticleExtrema") == 0)
         {
             m_multi_rd[i_rd]=
@@ -0,0 +1,136 @@
+/* Copyright 2021
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "ParticleMemory.H"
+#include "WarpX.H"
+
+using namespace amrex::literals;
+
+// constructor
+ParticleMemory::ParticleMemory (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+    // get a reference to WarpX instance
+    auto & warpx = WarpX::GetInstance();
+
+    // get MultiParticleContainer class object
+    const auto & mypc = warpx.GetPartContainer();
+
+    // get number of species (int)
+    const auto nSpecies = mypc.nSpecies();
+
+    // resize data array to 2*(nSpecies+1) (each species + sum over all species
+    // for both the memory of the particles and the allocated memory)
+    m_data.resize(2*(nSpecies+1), 0.0_rt);
+
+    // get species names (std::vector<std::string>)
+    const auto species_names = mypc.GetSpeciesNames();
+
+    if (amrex::ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            ofs << "#";
+            ofs << "[1]step()";
+            ofs << m_sep;
+            ofs << "[2]time(s)";
+            ofs << m_sep;
+            ofs << "[3]total live memory(B)";
+            // Column number of first species live memory
+            constexpr int shift_first_species_live = 4;
+            for (int i = 0; i < nSpecies; ++i)
+            {
+                ofs << m_sep;
+                ofs << "[" + std::to_string(shift_first_species_live+i) + "]";
+                ofs << species_names[i]+" live memory(B)";
+            }
+            // Column number of total allocated memory (summed over all species)
+            const int shift_total_allocated = shift_first_species_live + nSpecies;
+            ofs << m_sep;
+            ofs << "[" + std::to_string(shift_total_allocated) + "]";
+            ofs << "total allocated memory(B)";
+            // Column number of first species allocated memory
+            const int shift_first_species_allocated = shift_total_allocated + 1;
+            for (int i = 0; i < nSpecies; ++i)
+            {
+                ofs << m_sep;
+                ofs << "[" + std::to_string(shift_first_species_allocated+i) + "]";
+                ofs << species_names[i]+" allocated memory(B)";
+            }
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+
+}
+// end constructor
+
+// function that computes the memory used by the particles
+void ParticleMemory::ComputeDiags (int step)
+{
+
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    // get MultiParticleContainer class object
+    const auto & mypc = WarpX::GetInstance().GetPartContainer();
+
+    // get number of species (int)
+    const auto nSpecies = mypc.nSpecies();
+
+    // Index of total live memory (all species) in m_data
+    constexpr int idx_total_live = 0;
+    // Index of first species live memory in m_data
+    constexpr int idx_first_species_live = 1;
+    // Index of total allocated memory (all species) in m_data
+    const int idx_total_allocated = idx_first_species_live + nSpecies;
+    // Index of first species allocated memory in m_data
+    const int idx_first_species_allocated = idx_total_allocated + 1;
+
+    // Memory of the particles and allocated memory, for each species, on this MPI rank
+    amrex::Vector<amrex::Long> bytes(2*nSpecies, 0);
+    for (int i_s = 0; i_s < nSpecies; ++i_s)
+    {
+        mypc.GetParticleContainer(i_s).MemoryUsage(bytes[i_s], bytes[nSpecies + i_s]);
+    }
+
+    // MPI reduction
+    amrex::ParallelDescriptor::ReduceLongSum
+        (bytes.data(), bytes.size(), amrex::ParallelDescriptor::IOProcessorNumber());
+
+    // Initialize total memory (all species) to 0
+    m_data[idx_total_live] = 0.0_rt;
+    m_data[idx_total_allocated] = 0.0_rt;
+
+    // loop over species
+    for (int i_s = 0; i_s < nSpecies; ++i_s)
+    {
+        m_data[idx_first_species_live + i_s] = static_cast<amrex::Real>(bytes[i_s]);
+        m_data[idx_first_species_allocated + i_s] = static_cast<amrex::Real>(bytes[nSpecies + i_s]);
+
+        // Increase total memory (all species)
+        m_data[idx_total_live] += m_data[idx_first_species_live + i_s];
+        m_data[idx_total_allocated] += m_data[idx_first_species_allocated + i_s];
+    }
+    // end loop over species
+
+    /* m_data now contains up-to-date values for:
+     *  [memory of the particles (all species),
+     *   memory of the particles (species 1),
+     *   ...,
+     *   memory of the particles (species n)
+     *   allocated memory (all species),
+     *   allocated memory (species 1),
+     *   ...,
+     *   allocated memory (species n)] */
+
+}
+// end void ParticleMemory::ComputeDiags
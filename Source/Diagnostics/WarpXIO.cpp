@@ -11,6 +11,7 @@
 #include "FieldIO.H"
 #include "SliceDiagnostic.H"
 #include "Utils/CoarsenIO.H"
+#include "Parallelization/WarpXCommUtil.H"
 
 #ifdef WARPX_USE_OPENPMD
 #   include "Diagnostics/WarpXOpenPMD.H"
@@ -24,7 +25,9 @@
 #   include <AMReX_AmrMeshInSituBridge.H>
 #endif
 
+#include <array>
 #include <memory>
+#include <utility>
 
 using namespace amrex;
 
@@ -239,6 +242,93 @@ WarpX::InitFromCheckpoint ()
     mypc->AllocData();
     mypc->Restart(restart_chkfile);
 
+    if (regrid_on_restart) {
+        RegridFromCheckpoint();
+    }
+}
+
+void
+WarpX::RegridFromCheckpoint ()
+{
+    WARPX_PROFILE("WarpX::RegridFromCheckpoint()");
+
+    // Fields read from the checkpoint, on the boxes of the checkpoint
+    struct CheckpointFields
+    {
+        // Declared first, so that it is destroyed after the fields that it contains
+        std::unique_ptr<SharedMemoryArena> arena;
+        std::array<std::unique_ptr<MultiFab>,3> E_fp, B_fp, j_fp, E_cp, B_cp, j_cp;
+    };
+
+    const int nlevs = finestLevel()+1;
+    bool regridded = false;
+
+    for (int lev = 0; lev < nlevs; ++lev)
+    {
+        BoxArray new_ba;
+        if (lev == 0) {
+            new_ba = MakeBaseGrids();
+        } else {
+            new_ba = BoxArray(boxArray(lev).simplified_list());
+            new_ba.maxSize(maxGridSize(lev));
+        }
+        if (new_ba == boxArray(lev)) continue;
+        regridded = true;
+
+        CheckpointFields old;
+        old.arena = std::move(m_field_arena[lev]);
+        for (int i = 0; i < 3; ++i) {
+            old.E_fp[i] = std::move(Efield_fp[lev][i]);
+            old.B_fp[i] = std::move(Bfield_fp[lev][i]);
+            old.j_fp[i] = std::move(current_fp[lev][i]);
+            old.E_cp[i] = std::move(Efield_cp[lev][i]);
+            old.B_cp[i] = std::move(Bfield_cp[lev][i]);
+            old.j_cp[i] = std::move(current_cp[lev][i]);
+        }
+        ClearLevel(lev);
+
+        const DistributionMapping new_dm {new_ba, ParallelDescriptor::NProcs()};
+        SetBoxArray(lev, new_ba);
+        SetDistributionMap(lev, new_dm);
+        AllocLevelData(lev, new_ba, new_dm);
+
+        const Periodicity& period = Geom(lev).periodicity();
+        for (int i = 0; i < 3; ++i) {
+            current_fp[lev][i]->setVal(0.0);
+            WarpXCommUtil::CopyByOverlap(*Efield_fp[lev][i], *old.E_fp[i], period);
+            WarpXCommUtil::CopyByOverlap(*Bfield_fp[lev][i], *old.B_fp[i], period);
+            if (is_synchronized) {
+                WarpXCommUtil::CopyByOverlap(*current_fp[lev][i], *old.j_fp[i], period);
+            }
+        }
+
+        if (lev > 0) {
+            const Periodicity& cperiod = Geom(lev-1).periodicity();
+            for (int i = 0; i < 3; ++i) {
+                Efield_aux[lev][i]->setVal(0.0);
+                Bfield_aux[lev][i]->setVal(0.0);
+                current_cp[lev][i]->setVal(0.0);
+                WarpXCommUtil::CopyByOverlap(*Efield_cp[lev][i], *old.E_cp[i], cperiod);
+                WarpXCommUtil::CopyByOverlap(*Bfield_cp[lev][i], *old.B_cp[i], cperiod);
+                if (is_synchronized) {
+                    WarpXCommUtil::CopyByOverlap(*current_cp[lev][i], *old.j_cp[i], cperiod);
+                }
+            }
+        }
+
+        amrex::Print() << "  Level " << lev << " regridded from " << old.E_fp[0]->boxArray().size()
+                       << " to " << new_ba.size() << " grids\n";
+    }
+
+    if (!regridded) return;
+
+    if (do_pml) {
+        RemakePML();
+    }
+
+    // Move the particles to the tiles of the new grids
+    mypc->Redistribute();
+    mypc->defineAllParticleTiles();
 }
 
 
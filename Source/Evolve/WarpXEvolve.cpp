@@ -13,6 +13,7 @@
 #include "Utils/WarpXConst.H"
 #include "Utils/WarpXUtil.H"
 #include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXPlugin.H"
 #include "Python/WarpX_py.H"
 #ifdef WARPX_USE_PSATD
 #   include "FieldSolver/SpectralSolver/SpectralSolver.H"
@@ -55,6 +56,7 @@ WarpX::Evolve (int numsteps)
         amrex::Print() << "\nSTEP " << step+1 << " starts ...\n";
 
         if (warpx_py_beforestep) warpx_py_beforestep();
+        WarpXPlugins::CallHook(&WarpXPlugin::BeforeStep, *this);
 
         amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(0);
         if (cost) {
@@ -84,6 +86,11 @@ WarpX::Evolve (int numsteps)
             }
         }
 
+        // Regrid the refined levels with the dynamic tagging criteria
+        if (regrid_int > 0 && max_level > 0 && step > 0 && step % regrid_int == 0) {
+            DynamicRegrid(cur_time);
+        }
+
         // At the beginning, we have B^{n} and E^{n}.
         // Particles have p^{n} and x^{n}.
         // is_synchronized is true.
@@ -130,7 +137,7 @@ WarpX::Evolve (int numsteps)
             // E : guard cells are up-to-date
             // B : guard cells are NOT up-to-date
             // F : guard cells are NOT up-to-date
-        } else if (do_subcycling == 1 && finest_level == 1) {
+        } else if (do_subcycling == 1) {
             OneStep_sub1(cur_time);
         } else {
             amrex::Print() << "Error: do_subcycling = " << do_subcycling << std::endl;
@@ -144,6 +151,7 @@ WarpX::Evolve (int numsteps)
         }
 
         if (warpx_py_beforeEsolve) warpx_py_beforeEsolve();
+        WarpXPlugins::CallHook(&WarpXPlugin::BeforeEsolve, *this);
 
         if (cur_time + dt[0] >= stop_time - 1.e-3*dt[0] || step == numsteps_max-1) {
             // At the end of last step, push p by 0.5*dt to synchronize
@@ -160,6 +168,7 @@ WarpX::Evolve (int numsteps)
         }
 
         if (warpx_py_afterEsolve) warpx_py_afterEsolve();
+        WarpXPlugins::CallHook(&WarpXPlugin::AfterEsolve, *this);
 
         for (int lev = 0; lev <= max_level; ++lev) {
             ++istep[lev];
@@ -211,8 +220,18 @@ WarpX::Evolve (int numsteps)
 
 
         if (sort_intervals.contains(step+1)) {
-            amrex::Print() << "re-sorting particles \n";
-            mypc->SortParticlesByBin(sort_bin_size);
+            if (sort_locality_threshold < 0._rt && !sort_space_filling_curve) {
+                amrex::Print() << "re-sorting particles \n";
+                mypc->SortParticlesByBin(sort_bin_size);
+            } else {
+                // Only sort the tiles whose locality has degraded
+                int nsorted = mypc->SortTilesByBin(sort_bin_size, sort_locality_threshold,
+                                                   sort_space_filling_curve);
+                if (verbose) {
+                    amrex::ParallelDescriptor::ReduceIntSum(nsorted, amrex::ParallelDescriptor::IOProcessorNumber());
+                    amrex::Print() << "re-sorting particles in " << nsorted << " tiles \n";
+                }
+            }
         }
 
         if( do_electrostatic != ElectrostaticSolverAlgo::None ) {
@@ -252,6 +271,7 @@ WarpX::Evolve (int numsteps)
         }
 
         if (warpx_py_afterstep) warpx_py_afterstep();
+        WarpXPlugins::CallHook(&WarpXPlugin::AfterStep, *this);
 
         // inputs: unused parameters (e.g. typos) check after step 1 has finished
         if (!early_params_checked) {
@@ -291,24 +311,29 @@ WarpX::OneStep_nosub (Real cur_time)
     // Deposit current j^{n+1/2}
     // Deposit charge density rho^{n}
     if (warpx_py_particleinjection) warpx_py_particleinjection();
+    WarpXPlugins::CallHook(&WarpXPlugin::ParticleInjection, *this);
     if (warpx_py_particlescraper) warpx_py_particlescraper();
+    WarpXPlugins::CallHook(&WarpXPlugin::ParticleScraper, *this);
     if (warpx_py_beforedeposition) warpx_py_beforedeposition();
+    WarpXPlugins::CallHook(&WarpXPlugin::BeforeDeposition, *this);
     PushParticlesandDepose(cur_time);
 
     if (warpx_py_afterdeposition) warpx_py_afterdeposition();
+    WarpXPlugins::CallHook(&WarpXPlugin::AfterDeposition, *this);
 
 // TODO
 // Apply current correction in Fourier space: for domain decomposition with local
 // FFTs over guard cells, apply this before calling SyncCurrent
     if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
-        if (!fft_periodic_single_box && current_correction)
+        const bool global_fft = fft_periodic_single_box || fft_distributed;
+        if (!global_fft && current_correction)
             amrex::Abort(
                     "\nCurrent correction does not guarantee charge conservation with local FFTs over guard cells:\n"
-                    "set psatd.periodic_single_box_fft=1 too, in order to guarantee charge conservation");
-        if (!fft_periodic_single_box && (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vay))
+                    "set psatd.periodic_single_box_fft=1 or psatd.distributed_fft=1 too, in order to guarantee charge conservation");
+        if (!global_fft && (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vay))
             amrex::Abort(
                     "\nVay current deposition does not guarantee charge conservation with local FFTs over guard cells:\n"
-                    "set psatd.periodic_single_box_fft=1 too, in order to guarantee charge conservation");
+                    "set psatd.periodic_single_box_fft=1 or psatd.distributed_fft=1 too, in order to guarantee charge conservation");
     }
 
 #ifdef WARPX_QED
@@ -323,11 +348,12 @@ WarpX::OneStep_nosub (Real cur_time)
     SyncCurrent();
     SyncRho();
 
-    // Apply current correction in Fourier space: for periodic single-box global FFTs
-    // without guard cells, apply this after calling SyncCurrent
+    // Apply current correction in Fourier space: for periodic single-box or
+    // distributed global FFTs without guard cells, apply this after calling SyncCurrent
     if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
-        if (fft_periodic_single_box && current_correction) CurrentCorrection();
-        if (fft_periodic_single_box && (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vay))
+        const bool global_fft = fft_periodic_single_box || fft_distributed;
+        if (global_fft && current_correction) CurrentCorrection();
+        if (global_fft && (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vay))
             VayDeposition();
     }
 
@@ -399,22 +425,13 @@ WarpX::OneStep_nosub (Real cur_time)
 }
 
 /* /brief Perform one PIC iteration, with subcycling
-*  i.e. The fine patch uses a smaller timestep (and steps more often)
-*  than the coarse patch, for the field advance and particle pusher.
-*
-* This version of subcycling only works for 2 levels and with a refinement
-* ratio of 2.
-* The particles and fields of the fine patch are pushed twice
-* (with dt[coarse]/2) in this routine.
-* The particles of the coarse patch and mother grid are pushed only once
-* (with dt[coarse]). The fields on the coarse patch and mother grid
-* are pushed in a way which is equivalent to pushing once only, with
-* a current which is the average of the coarse + fine current at the 2
-* steps of the fine grid.
+*  i.e. each level uses its own timestep (set by its own CFL limit) for the
+*  field advance and particle pusher: a level performs refRatio substeps
+*  when the next coarser level performs one step.
 *
+* This works for any number of levels: the levels are advanced recursively
+* by OneStep_sub, starting from level 0 (see below).
 */
-
-
 void
 WarpX::OneStep_sub1 (Real curtime)
 {
@@ -436,113 +453,145 @@ WarpX::OneStep_sub1 (Real curtime)
     // value of step in code (first step is 0)
     mypc->doResampling(istep[0]+1);
 
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(finest_level == 1, "Must have exactly two levels");
-    const int fine_lev = 1;
-    const int coarse_lev = 0;
-
-    // i) Push particles and fields on the fine patch (first fine step)
-    PushParticlesandDepose(fine_lev, curtime, DtType::FirstHalf);
-    RestrictCurrentFromFineToCoarsePatch(fine_lev);
-    RestrictRhoFromFineToCoarsePatch(fine_lev);
-    ApplyFilterandSumBoundaryJ(fine_lev, PatchType::fine);
-    NodalSyncJ(fine_lev, PatchType::fine);
-    ApplyFilterandSumBoundaryRho(fine_lev, PatchType::fine, 0, 2*ncomps);
-    NodalSyncRho(fine_lev, PatchType::fine, 0, 2);
-
-    EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::FirstHalf);
-    FillBoundaryB(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-    FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_alloc_F);
-
-    EvolveE(fine_lev, PatchType::fine, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldGather);
+    OneStep_sub(0, curtime, DtType::Full);
+}
 
-    EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::SecondHalf);
+/* /brief Advance level `lev` and all the finer levels by dt[lev]
+*
+* On the finest level, the particles and the fields of the fine patch are
+* pushed by one step. On a coarser level, with `nsub` = refRatio(lev) substeps
+* of the next finer level:
+* - the finer levels perform their substeps (recursively)
+* - the particles of `lev` are pushed only once (with dt[lev]), after the
+*   first substep of the finer levels
+* - the fields of the fine patch of `lev` and of the coarse patch of `lev+1`
+*   are pushed in a way which is equivalent to pushing once only, with a
+*   current which is the average of the coarse + fine current over the
+*   substeps: B is pushed by half a step before the first substep and after
+*   the last one, and E is pushed by dt[lev]/nsub after each substep, with
+*   the current of this substep.
+* With 2 levels and a refinement ratio of 2, this is the algorithm of
+* https://ieeexplore.ieee.org/document/8659392.
+*
+* \param[in] lev level that is advanced
+* \param[in] cur_time time at the beginning of the step of `lev`
+* \param[in] a_dt_type which part of the step of level 0 this step is
+*/
+void
+WarpX::OneStep_sub (int lev, Real cur_time, DtType a_dt_type)
+{
+    if (lev == finest_level)
+    {
+        // Push particles and fields on the fine patch
+        PushParticlesandDepose(lev, cur_time, a_dt_type);
+        if (lev > 0) {
+            RestrictCurrentFromFineToCoarsePatch(lev);
+            RestrictRhoFromFineToCoarsePatch(lev);
+        }
+        ApplyFilterandSumBoundaryJ(lev, PatchType::fine);
+        NodalSyncJ(lev, PatchType::fine);
+        ApplyFilterandSumBoundaryRho(lev, PatchType::fine, 0, 2*ncomps);
+        NodalSyncRho(lev, PatchType::fine, 0, 2);
+
+        EvolveB(lev, PatchType::fine, 0.5_rt*dt[lev]);
+        EvolveF(lev, PatchType::fine, 0.5_rt*dt[lev], DtType::FirstHalf);
+        FillBoundaryB(lev, PatchType::fine, guard_cells.ng_FieldSolver);
+        FillBoundaryF(lev, PatchType::fine, guard_cells.ng_alloc_F);
+
+        EvolveE(lev, PatchType::fine, dt[lev]);
+        FillBoundaryE(lev, PatchType::fine, guard_cells.ng_FieldGather);
+
+        EvolveB(lev, PatchType::fine, 0.5_rt*dt[lev]);
+        EvolveF(lev, PatchType::fine, 0.5_rt*dt[lev], DtType::SecondHalf);
+
+        if (do_pml) {
+            FillBoundaryF(lev, PatchType::fine, guard_cells.ng_alloc_F);
+            DampPML(lev, PatchType::fine);
+            FillBoundaryE(lev, PatchType::fine, guard_cells.ng_FieldGather);
+        }
 
-    if (do_pml) {
-        FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_alloc_F);
-        DampPML(fine_lev, PatchType::fine);
-        FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldGather);
+        if ( safe_guard_cells )
+            FillBoundaryF(lev, PatchType::fine, guard_cells.ng_FieldSolver);
+        FillBoundaryB(lev, PatchType::fine, guard_cells.ng_FieldGather);
+        return;
     }
 
-    FillBoundaryB(fine_lev, PatchType::fine, guard_cells.ng_FieldGather);
-
-    // ii) Push particles on the coarse patch and mother grid.
-    // Push the fields on the coarse patch and mother grid
-    // by only half a coarse step (first half)
-    PushParticlesandDepose(coarse_lev, curtime, DtType::Full);
-    StoreCurrent(coarse_lev);
-    AddCurrentFromFineLevelandSumBoundary(coarse_lev);
-    AddRhoFromFineLevelandSumBoundary(coarse_lev, 0, ncomps);
-
-    EvolveB(fine_lev, PatchType::coarse, dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::coarse, dt[fine_lev], DtType::FirstHalf);
-    FillBoundaryB(fine_lev, PatchType::coarse, guard_cells.ng_FieldGather);
-    FillBoundaryF(fine_lev, PatchType::coarse, guard_cells.ng_FieldSolverF);
-
-    EvolveE(fine_lev, PatchType::coarse, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::coarse, guard_cells.ng_FieldGather);
-
-    EvolveB(coarse_lev, PatchType::fine, 0.5_rt*dt[coarse_lev]);
-    EvolveF(coarse_lev, PatchType::fine, 0.5_rt*dt[coarse_lev], DtType::FirstHalf);
-    FillBoundaryB(coarse_lev, PatchType::fine, guard_cells.ng_FieldGather + guard_cells.ng_Extra);
-    FillBoundaryF(coarse_lev, PatchType::fine, guard_cells.ng_FieldSolverF);
+    const int fine_lev = lev+1;
+    // Same ratio as in ComputeDt
+    const int nsub = refRatio(lev)[0];
+    const Real dt_sub = dt[lev]/nsub;
 
-    EvolveE(coarse_lev, PatchType::fine, 0.5_rt*dt[coarse_lev]);
-    FillBoundaryE(coarse_lev, PatchType::fine, guard_cells.ng_FieldGather + guard_cells.ng_Extra);
+    for (int isub = 0; isub < nsub; ++isub)
+    {
+        if (isub > 0) {
+            // Get auxiliary fields on the finer levels, at the beginning of this substep
+            // TODO Remove call to FillBoundaryAux before UpdateAuxilaryData?
+            FillBoundaryAux(guard_cells.ng_UpdateAux);
+            UpdateAuxilaryData();
+            FillBoundaryAux(guard_cells.ng_UpdateAux);
+        }
 
-    // TODO Remove call to FillBoundaryAux before UpdateAuxilaryData?
-    FillBoundaryAux(guard_cells.ng_UpdateAux);
-    // iii) Get auxiliary fields on the fine grid, at dt[fine_lev]
-    UpdateAuxilaryData();
-    FillBoundaryAux(guard_cells.ng_UpdateAux);
+        // i) Push particles and fields on the finer levels (one substep).
+        // Only the first (resp. last) substep of the first (resp. last) substep
+        // of the coarsest level is FirstHalf (resp. SecondHalf): the particles
+        // are split once per step of the coarsest level, at the end of it.
+        DtType sub_dt_type = DtType::Intermediate;
+        if (isub == 0 && a_dt_type != DtType::SecondHalf && a_dt_type != DtType::Intermediate) {
+            sub_dt_type = DtType::FirstHalf;
+        } else if (isub == nsub-1 && a_dt_type != DtType::FirstHalf && a_dt_type != DtType::Intermediate) {
+            sub_dt_type = DtType::SecondHalf;
+        }
+        OneStep_sub(fine_lev, cur_time + isub*dt_sub, sub_dt_type);
+
+        if (isub == 0) {
+            // ii) Push particles on this level, with the full step.
+            // Push B on the coarse patch of fine_lev and the fine patch of lev
+            // by half a step (first half)
+            PushParticlesandDepose(lev, cur_time, a_dt_type);
+            if (lev > 0) {
+                RestrictCurrentFromFineToCoarsePatch(lev);
+                RestrictRhoFromFineToCoarsePatch(lev);
+            }
+            StoreCurrent(lev);
 
-    // iv) Push particles and fields on the fine patch (second fine step)
-    PushParticlesandDepose(fine_lev, curtime+dt[fine_lev], DtType::SecondHalf);
-    RestrictCurrentFromFineToCoarsePatch(fine_lev);
-    RestrictRhoFromFineToCoarsePatch(fine_lev);
-    ApplyFilterandSumBoundaryJ(fine_lev, PatchType::fine);
-    NodalSyncJ(fine_lev, PatchType::fine);
-    ApplyFilterandSumBoundaryRho(fine_lev, PatchType::fine, 0, ncomps);
-    NodalSyncRho(fine_lev, PatchType::fine, 0, 2);
+            EvolveB(fine_lev, PatchType::coarse, 0.5_rt*dt[lev]);
+            EvolveF(fine_lev, PatchType::coarse, 0.5_rt*dt[lev], DtType::FirstHalf);
+            FillBoundaryB(fine_lev, PatchType::coarse, guard_cells.ng_FieldGather);
+            FillBoundaryF(fine_lev, PatchType::coarse, guard_cells.ng_FieldSolverF);
 
-    EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::FirstHalf);
-    FillBoundaryB(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-    FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_FieldSolverF);
+            EvolveB(lev, PatchType::fine, 0.5_rt*dt[lev]);
+            EvolveF(lev, PatchType::fine, 0.5_rt*dt[lev], DtType::FirstHalf);
+            FillBoundaryB(lev, PatchType::fine, guard_cells.ng_FieldGather + guard_cells.ng_Extra);
+            FillBoundaryF(lev, PatchType::fine, guard_cells.ng_FieldSolverF);
+        } else {
+            // Current deposited by the particles of this level only
+            RestoreCurrent(lev);
+        }
 
-    EvolveE(fine_lev, PatchType::fine, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
+        // iii) Add the current of this substep of fine_lev, and push E
+        // on the coarse patch of fine_lev and the fine patch of lev
+        AddCurrentFromFineLevelandSumBoundary(lev);
+        if (isub == 0) AddRhoFromFineLevelandSumBoundary(lev, 0, ncomps);
+        if (isub == nsub-1) AddRhoFromFineLevelandSumBoundary(lev, ncomps, ncomps);
 
-    EvolveB(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::fine, 0.5_rt*dt[fine_lev], DtType::SecondHalf);
+        EvolveE(fine_lev, PatchType::coarse, dt_sub);
+        FillBoundaryE(fine_lev, PatchType::coarse, guard_cells.ng_FieldGather);
 
-    if (do_pml) {
-        DampPML(fine_lev, PatchType::fine);
-        FillBoundaryE(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
+        EvolveE(lev, PatchType::fine, dt_sub);
+        FillBoundaryE(lev, PatchType::fine, guard_cells.ng_FieldGather + guard_cells.ng_Extra);
     }
 
-    if ( safe_guard_cells )
-        FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-    FillBoundaryB(fine_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-
-    // v) Push the fields on the coarse patch and mother grid
-    // by only half a coarse step (second half)
-    RestoreCurrent(coarse_lev);
-    AddCurrentFromFineLevelandSumBoundary(coarse_lev);
-    AddRhoFromFineLevelandSumBoundary(coarse_lev, ncomps, ncomps);
-
-    EvolveE(fine_lev, PatchType::coarse, dt[fine_lev]);
-    FillBoundaryE(fine_lev, PatchType::coarse, guard_cells.ng_FieldSolver);
-
-    EvolveB(fine_lev, PatchType::coarse, dt[fine_lev]);
-    EvolveF(fine_lev, PatchType::coarse, dt[fine_lev], DtType::SecondHalf);
+    // iv) Push B on the coarse patch of fine_lev and the fine patch of lev
+    // by half a step (second half)
+    EvolveB(fine_lev, PatchType::coarse, 0.5_rt*dt[lev]);
+    EvolveF(fine_lev, PatchType::coarse, 0.5_rt*dt[lev], DtType::SecondHalf);
 
     if (do_pml) {
-        FillBoundaryF(fine_lev, PatchType::fine, guard_cells.ng_FieldSolverF);
-        DampPML(fine_lev, PatchType::coarse); // do it twice
-        DampPML(fine_lev, PatchType::coarse);
+        FillBoundaryF(fine_lev, PatchType::coarse, guard_cells.ng_FieldSolverF);
+        // once per substep of fine_lev
+        for (int isub = 0; isub < nsub; ++isub) {
+            DampPML(fine_lev, PatchType::coarse);
+        }
         FillBoundaryE(fine_lev, PatchType::coarse, guard_cells.ng_alloc_EB);
     }
 
@@ -550,26 +599,25 @@ WarpX::OneStep_sub1 (Real curtime)
 
     FillBoundaryF(fine_lev, PatchType::coarse, guard_cells.ng_FieldSolverF);
 
-    EvolveE(coarse_lev, PatchType::fine, 0.5_rt*dt[coarse_lev]);
-    FillBoundaryE(coarse_lev, PatchType::fine, guard_cells.ng_FieldSolver);
-
-    EvolveB(coarse_lev, PatchType::fine, 0.5_rt*dt[coarse_lev]);
-    EvolveF(coarse_lev, PatchType::fine, 0.5_rt*dt[coarse_lev], DtType::SecondHalf);
+    EvolveB(lev, PatchType::fine, 0.5_rt*dt[lev]);
+    EvolveF(lev, PatchType::fine, 0.5_rt*dt[lev], DtType::SecondHalf);
 
     if (do_pml) {
         if (do_moving_window){
             // Exchance guard cells of PMLs only (0 cells are exchanged for the
             // regular B field MultiFab). This is required as B and F have just been
             // evolved.
-            FillBoundaryB(coarse_lev, PatchType::fine, IntVect::TheZeroVector());
-            FillBoundaryF(coarse_lev, PatchType::fine, IntVect::TheZeroVector());
+            FillBoundaryB(lev, PatchType::fine, IntVect::TheZeroVector());
+            FillBoundaryF(lev, PatchType::fine, IntVect::TheZeroVector());
         }
-        DampPML(coarse_lev, PatchType::fine);
+        DampPML(lev, PatchType::fine);
         if ( safe_guard_cells )
-            FillBoundaryE(coarse_lev, PatchType::fine, guard_cells.ng_FieldSolver);
+            FillBoundaryE(lev, PatchType::fine, guard_cells.ng_FieldSolver);
     }
-    if ( safe_guard_cells )
-        FillBoundaryB(coarse_lev, PatchType::fine, guard_cells.ng_FieldSolver);
+    // The guard cells of the intermediate levels are needed to update
+    // the auxiliary fields of the finer levels
+    if ( safe_guard_cells || lev > 0 )
+        FillBoundaryB(lev, PatchType::fine, guard_cells.ng_FieldSolver);
 }
 
 void
@@ -140,7 +140,8 @@ WarpX::AddSpaceChargeFieldLabFrame ()
 
 /* Compute the potential `phi` by solving the Poisson equation with `rho` as
    a source, assuming that the source moves at a constant speed \f$\vec{\beta}\f$.
-   This uses the amrex solver.
+   This uses the amrex solver, or the FFT-based solver if
+   `warpx.poisson_solver = fft`.
 
    More specifically, this solves the equation
    \f[
@@ -158,6 +159,14 @@ WarpX::computePhi (const amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rho,
                    Real const required_precision,
                    int const max_iters) const
 {
+#if defined(WARPX_USE_PSATD) && !defined(WARPX_DIM_RZ)
+    if (poisson_solver_id == PoissonSolverAlgo::FFT) {
+        // Direct solve on level 0 (mesh refinement is not supported in this case)
+        m_poisson_fft_solver->Solve( *rho[0], *phi[0], beta );
+        return;
+    }
+#endif
+
     // Define the boundary conditions
     Array<LinOpBCType,AMREX_SPACEDIM> lobc, hibc;
     for (int idim=0; idim<AMREX_SPACEDIM; idim++){
@@ -15,6 +15,45 @@
 #if WARPX_USE_PSATD
 using namespace amrex;
 
+namespace {
+    /**
+     * \brief Compute the coefficients of the update equations for the norm
+     * `k_norm` of the (modified) k vector, used both when the coefficients
+     * are stored and when they are computed on the fly in pushSpectralFields
+     */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    void ComputePsatdCoefficients (const Real k_norm, const Real dt, const bool update_with_rho,
+                                   Real& C, Real& S_ck, Real& X1, Real& X2, Real& X3) noexcept
+    {
+        constexpr Real c = PhysConst::c;
+        constexpr Real eps0 = PhysConst::ep0;
+
+        if (k_norm != 0) {
+            C    = std::cos(c*k_norm*dt);
+            S_ck = std::sin(c*k_norm*dt)/(c*k_norm);
+            X1 = (1.0_rt-C)/(eps0*c*c*k_norm*k_norm);
+            if (update_with_rho) {
+                X2 = (1.0_rt-S_ck/dt)/(eps0*k_norm*k_norm);
+                X3 = (C-S_ck/dt)/(eps0*k_norm*k_norm);
+            } else {
+                X2 = (1.0_rt-C)/(k_norm*k_norm);
+                X3 = (S_ck-dt)/(k_norm*k_norm);
+            }
+        } else { // Handle k_norm = 0 with analytical limit
+            C = 1.0_rt;
+            S_ck = dt;
+            X1 = 0.5_rt*dt*dt/eps0;
+            if (update_with_rho) {
+                X2 = c*c*dt*dt/(6.0_rt*eps0);
+                X3 = -c*c*dt*dt/(3.0_rt*eps0);
+            } else {
+                X2 = 0.5_rt*dt*dt*c*c;
+                X3 = -c*c*dt*dt*dt/6.0_rt;
+            }
+        }
+    }
+}
+
 /**
  * \brief Constructor
  */
@@ -22,12 +61,17 @@ PsatdAlgorithm::PsatdAlgorithm(const SpectralKSpace& spectral_kspace,
                          const DistributionMapping& dm,
                          const int norder_x, const int norder_y,
                          const int norder_z, const bool nodal, const Real dt,
-                         const bool update_with_rho)
+                         const bool update_with_rho,
+                         const bool on_the_fly_coefficients)
     // Initialize members of base class
     : SpectralBaseAlgorithm(spectral_kspace, dm, norder_x, norder_y, norder_z, nodal),
       m_dt(dt),
-      m_update_with_rho(update_with_rho)
+      m_update_with_rho(update_with_rho),
+      m_on_the_fly_coefficients(on_the_fly_coefficients)
 {
+    // The coefficients are recomputed at each push from the k vectors
+    if (m_on_the_fly_coefficients) return;
+
     const BoxArray& ba = spectral_kspace.spectralspace_ba;
 
     // Allocate the arrays of coefficients
@@ -48,6 +92,8 @@ void
 PsatdAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
 
     const bool update_with_rho = m_update_with_rho;
+    const bool on_the_fly_coefficients = m_on_the_fly_coefficients;
+    const Real dt = m_dt;
 
     // Loop over boxes
     for (MFIter mfi(f.fields); mfi.isValid(); ++mfi){
@@ -56,12 +102,15 @@ PsatdAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
 
         // Extract arrays for the fields to be updated
         Array4<Complex> fields = f.fields[mfi].array();
-        // Extract arrays for the coefficients
-        Array4<const Real> C_arr = C_coef[mfi].array();
-        Array4<const Real> S_ck_arr = S_ck_coef[mfi].array();
-        Array4<const Real> X1_arr = X1_coef[mfi].array();
-        Array4<const Real> X2_arr = X2_coef[mfi].array();
-        Array4<const Real> X3_arr = X3_coef[mfi].array();
+        // Extract arrays for the coefficients (not allocated when computed on the fly)
+        Array4<const Real> C_arr, S_ck_arr, X1_arr, X2_arr, X3_arr;
+        if (!on_the_fly_coefficients) {
+            C_arr = C_coef[mfi].const_array();
+            S_ck_arr = S_ck_coef[mfi].const_array();
+            X1_arr = X1_coef[mfi].const_array();
+            X2_arr = X2_coef[mfi].const_array();
+            X3_arr = X3_coef[mfi].const_array();
+        }
         // Extract pointers for the k vectors
         const Real* modified_kx_arr = modified_kx_vec[mfi].dataPtr();
 #if (AMREX_SPACEDIM==3)
@@ -102,11 +151,17 @@ PsatdAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
 
             const Complex I = Complex{0,1};
 
-            const Real C = C_arr(i,j,k);
-            const Real S_ck = S_ck_arr(i,j,k);
-            const Real X1 = X1_arr(i,j,k);
-            const Real X2 = X2_arr(i,j,k);
-            const Real X3 = X3_arr(i,j,k);
+            Real C, S_ck, X1, X2, X3;
+            if (on_the_fly_coefficients) {
+                const Real k_norm = std::sqrt(kx*kx + ky*ky + kz*kz);
+                ComputePsatdCoefficients(k_norm, dt, update_with_rho, C, S_ck, X1, X2, X3);
+            } else {
+                C = C_arr(i,j,k);
+                S_ck = S_ck_arr(i,j,k);
+                X1 = X1_arr(i,j,k);
+                X2 = X2_arr(i,j,k);
+                X3 = X3_arr(i,j,k);
+            }
 
             // Update E (see WarpX online documentation: theory section)
 
@@ -189,32 +244,8 @@ void PsatdAlgorithm::InitializeSpectralCoefficients(const SpectralKSpace& spectr
                 std::pow(modified_kz[j],2));
 #endif
             // Calculate coefficients
-            constexpr Real c = PhysConst::c;
-            constexpr Real eps0 = PhysConst::ep0;
-
-            if (k_norm != 0) {
-                C(i,j,k)    = std::cos(c*k_norm*dt);
-                S_ck(i,j,k) = std::sin(c*k_norm*dt)/(c*k_norm);
-                X1(i,j,k) = (1.0_rt-C(i,j,k))/(eps0*c*c*k_norm*k_norm);
-                if (update_with_rho) {
-                    X2(i,j,k) = (1.0_rt-S_ck(i,j,k)/dt)/(eps0*k_norm*k_norm);
-                    X3(i,j,k) = (C(i,j,k)-S_ck(i,j,k)/dt)/(eps0*k_norm*k_norm);
-                } else {
-                    X2(i,j,k) = (1.0_rt-C(i,j,k))/(k_norm*k_norm);
-                    X3(i,j,k) = (S_ck(i,j,k)-dt)/(k_norm*k_norm);
-                }
-            } else { // Handle k_norm = 0 with analytical limit
-                C(i,j,k) = 1.0_rt;
-                S_ck(i,j,k) = dt;
-                X1(i,j,k) = 0.5_rt*dt*dt/eps0;
-                if (update_with_rho) {
-                    X2(i,j,k) = c*c*dt*dt/(6.0_rt*eps0);
-                    X3(i,j,k) = -c*c*dt*dt/(3.0_rt*eps0);
-                } else {
-                    X2(i,j,k) = 0.5_rt*dt*dt*c*c;
-                    X3(i,j,k) = -c*c*dt*dt*dt/6.0_rt;
-                }
-            }
+            ComputePsatdCoefficients(k_norm, dt, update_with_rho,
+                C(i,j,k), S_ck(i,j,k), X1(i,j,k), X2(i,j,k), X3(i,j,k));
         } );
      }
 }
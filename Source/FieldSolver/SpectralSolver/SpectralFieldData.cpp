@@ -7,6 +7,11 @@
  */
 #include "SpectralFieldData.H"
 
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Periodicity.H>
+
+#include <algorithm>
+#include <cstddef>
 #include <map>
 
 #if WARPX_USE_PSATD
@@ -18,9 +23,11 @@ SpectralFieldData::SpectralFieldData( const amrex::BoxArray& realspace_ba,
                                       const SpectralKSpace& k_space,
                                       const amrex::DistributionMapping& dm,
                                       const int n_field_required,
-                                      const bool periodic_single_box )
+                                      const bool periodic_single_box,
+                                      const bool distributed_fft )
 {
     m_periodic_single_box = periodic_single_box;
+    m_distributed_fft = distributed_fft;
 
     const BoxArray& spectralspace_ba = k_space.spectralspace_ba;
 
@@ -31,7 +38,9 @@ SpectralFieldData::SpectralFieldData( const amrex::BoxArray& realspace_ba,
     // Allocate temporary arrays - in real space and spectral space
     // These arrays will store the data just before/after the FFT
     tmpRealField = MultiFab(realspace_ba, dm, 1, 0);
-    tmpSpectralField = SpectralField(spectralspace_ba, dm, 1, 0);
+    if (!m_distributed_fft) {
+        tmpSpectralField = SpectralField(spectralspace_ba, dm, 1, 0);
+    }
 
     // By default, we assume the FFT is done from/to a nodal grid in real space
     // It the FFT is performed from/to a cell-centered grid in real space,
@@ -56,6 +65,32 @@ SpectralFieldData::SpectralFieldData( const amrex::BoxArray& realspace_ba,
                                     ShiftType::TransformToCellCentered);
 #endif
 
+    // Distributed FFT: allocate the local arrays of the FFT library
+    // and create the plans (collective over all MPI ranks)
+    if (m_distributed_fft) {
+#ifdef WARPX_USE_FFTW_MPI
+        m_fft_domain = realspace_ba.minimalBox();
+        const IntVect fft_size = m_fft_domain.length();
+        int local_n, local_start;
+        // (at least one value, for the ranks that do not own any slab)
+        const std::ptrdiff_t alloc_local = std::max<std::ptrdiff_t>(1,
+            AnyFFT::DistributedLocalSize(fft_size, local_n, local_start, AMREX_SPACEDIM));
+        m_distributed_real.resize(2*alloc_local);
+        m_distributed_complex.resize(alloc_local);
+        auto* const complex_array =
+            reinterpret_cast<AnyFFT::Complex*>(m_distributed_complex.data());
+        m_distributed_plans.push_back(AnyFFT::CreateDistributedPlan(
+            fft_size, m_distributed_real.data(), complex_array,
+            AnyFFT::direction::R2C, AMREX_SPACEDIM));
+        m_distributed_plans.push_back(AnyFFT::CreateDistributedPlan(
+            fft_size, m_distributed_real.data(), complex_array,
+            AnyFFT::direction::C2R, AMREX_SPACEDIM));
+#else
+        amrex::Abort("Distributed FFTs require WarpX to be compiled with FFTW and MPI");
+#endif
+        return;
+    }
+
     // Allocate and initialize the FFT plans
     forward_plan = AnyFFT::FFTplans(spectralspace_ba, dm);
     backward_plan = AnyFFT::FFTplans(spectralspace_ba, dm);
@@ -82,7 +117,10 @@ SpectralFieldData::SpectralFieldData( const amrex::BoxArray& realspace_ba,
 
 SpectralFieldData::~SpectralFieldData()
 {
-    if (tmpRealField.size() > 0){
+    for (auto& plan : m_distributed_plans) {
+        AnyFFT::DestroyPlan(plan);
+    }
+    if (tmpRealField.size() > 0 && !m_distributed_fft){
         for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
             AnyFFT::DestroyPlan(forward_plan[mfi]);
             AnyFFT::DestroyPlan(backward_plan[mfi]);
@@ -97,6 +135,11 @@ void
 SpectralFieldData::ForwardTransform (const MultiFab& mf, const int field_index,
                                      const int i_comp, const IntVect& stag)
 {
+    if (m_distributed_fft) {
+        ForwardTransformDistributed(mf, field_index, i_comp, stag);
+        return;
+    }
+
     // Check field index type, in order to apply proper shift in spectral space
     const bool is_nodal_x = (stag[0] == amrex::IndexType::NODE) ? true : false;
 #if (AMREX_SPACEDIM == 3)
@@ -175,6 +218,11 @@ SpectralFieldData::BackwardTransform( MultiFab& mf,
                                       const int field_index,
                                       const int i_comp )
 {
+    if (m_distributed_fft) {
+        BackwardTransformDistributed(mf, field_index, i_comp);
+        return;
+    }
+
     // Check field index type, in order to apply proper shift in spectral space
     const bool is_nodal_x = mf.is_nodal(0);
 #if (AMREX_SPACEDIM == 3)
@@ -265,4 +313,209 @@ SpectralFieldData::BackwardTransform( MultiFab& mf,
     }
 }
 
+void
+SpectralFieldData::DistributedFFTLayout (const Box& domain, BoxArray& ba,
+                                         DistributionMapping& dm)
+{
+#ifdef WARPX_USE_FFTW_MPI
+    // The FFT library decomposes the domain along the last (slowest) dimension
+    constexpr int dir = AMREX_SPACEDIM-1;
+    int local_n, local_start;
+    AnyFFT::DistributedLocalSize(domain.length(), local_n, local_start, AMREX_SPACEDIM);
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    Vector<int> all_n(nprocs), all_start(nprocs);
+    ParallelAllGather::AllGather(local_n, all_n.data(), ParallelDescriptor::Communicator());
+    ParallelAllGather::AllGather(local_start, all_start.data(), ParallelDescriptor::Communicator());
+
+    // One box per MPI rank that owns a (non-empty) slab
+    BoxList bl;
+    Vector<int> pmap;
+    for (int rank = 0; rank < nprocs; ++rank) {
+        if (all_n[rank] == 0) continue;
+        Box bx = domain;
+        bx.setSmall(dir, domain.smallEnd(dir) + all_start[rank]);
+        bx.setBig(dir, domain.smallEnd(dir) + all_start[rank] + all_n[rank] - 1);
+        bl.push_back(bx);
+        pmap.push_back(rank);
+    }
+    ba.define(bl);
+    dm.define(pmap);
+#else
+    amrex::ignore_unused(domain, ba, dm);
+    amrex::Abort("Distributed FFTs require WarpX to be compiled with FFTW and MPI");
+#endif
+}
+
+/* \brief Distributed version of ForwardTransform: the valid cells of `mf`
+ *  are copied to the slabs of the global FFT before the transform */
+void
+SpectralFieldData::ForwardTransformDistributed (const MultiFab& mf, const int field_index,
+                                                const int i_comp, const IntVect& stag)
+{
+    // Check field index type, in order to apply proper shift in spectral space
+    const bool is_nodal_x = (stag[0] == amrex::IndexType::NODE) ? true : false;
+#if (AMREX_SPACEDIM == 3)
+    const bool is_nodal_y = (stag[1] == amrex::IndexType::NODE) ? true : false;
+    const bool is_nodal_z = (stag[2] == amrex::IndexType::NODE) ? true : false;
+#else
+    const bool is_nodal_z = (stag[1] == amrex::IndexType::NODE) ? true : false;
+#endif
+
+    // Copy the component `i_comp` of `mf` to a cell-centered MultiFab
+    // with the same boxes. As for the periodic single box, this discards
+    // the *last* point of `mf` in any direction that has *nodal* index type.
+    MultiFab mf_cell(amrex::convert(mf.boxArray(), IntVect::TheCellVector()),
+                     mf.DistributionMap(), 1, 0);
+    for ( MFIter mfi(mf_cell); mfi.isValid(); ++mfi ){
+        Array4<const Real> mf_arr = mf.const_array(mfi);
+        Array4<Real> cell_arr = mf_cell.array(mfi);
+        ParallelFor( mfi.validbox(),
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            cell_arr(i,j,k) = mf_arr(i,j,k,i_comp);
+        });
+    }
+
+    // Gather the data in the slabs of the FFT (all-to-all communication)
+    tmpRealField.ParallelCopy(mf_cell, 0, 0, 1);
+
+    // Copy the local slab to the padded array of the FFT library
+    const Dim3 nreal = amrex::length(m_fft_domain);
+    const int nx_padded = 2*(nreal.x/2 + 1);
+    for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
+        const Box& bx = mfi.validbox();
+        const Dim3 lo = amrex::lbound(bx);
+        const Dim3 hi = amrex::ubound(bx);
+        Array4<Real> padded_arr(m_distributed_real.data(), lo,
+                                Dim3{lo.x+nx_padded, hi.y+1, hi.z+1}, 1);
+        Array4<const Real> tmp_arr = tmpRealField.const_array(mfi);
+        ParallelFor( bx,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            padded_arr(i,j,k) = tmp_arr(i,j,k);
+        });
+    }
+
+    // Perform the distributed Fourier transform
+    // (collective over all MPI ranks, including those without a slab)
+    AnyFFT::Execute(m_distributed_plans[0]);
+
+    // Copy the spectral-space field to the appropriate index of `fields`
+    // and apply correcting shift factor (see ForwardTransform)
+    for ( MFIter mfi(fields); mfi.isValid(); ++mfi ){
+        const Box& spectralspace_bx = mfi.validbox();
+        const Dim3 hi = amrex::ubound(spectralspace_bx);
+        Array4<const Complex> tmp_arr(m_distributed_complex.data(),
+                                      amrex::lbound(spectralspace_bx),
+                                      Dim3{hi.x+1, hi.y+1, hi.z+1}, 1);
+        Array4<Complex> fields_arr = fields.array(mfi);
+        const Complex* xshift_arr = xshift_FFTfromCell[mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+        const Complex* yshift_arr = yshift_FFTfromCell[mfi].dataPtr();
+#endif
+        const Complex* zshift_arr = zshift_FFTfromCell[mfi].dataPtr();
+
+        ParallelFor( spectralspace_bx,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            Complex spectral_field_value = tmp_arr(i,j,k);
+            // Apply proper shift in each dimension
+            if (is_nodal_x==false) spectral_field_value *= xshift_arr[i];
+#if (AMREX_SPACEDIM == 3)
+            if (is_nodal_y==false) spectral_field_value *= yshift_arr[j];
+            if (is_nodal_z==false) spectral_field_value *= zshift_arr[k];
+#elif (AMREX_SPACEDIM == 2)
+            if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
+#endif
+            // Copy field into the right index
+            fields_arr(i,j,k,field_index) = spectral_field_value;
+        });
+    }
+}
+
+/* \brief Distributed version of BackwardTransform: the slabs of the global
+ *  FFT are copied back to the valid cells of `mf` after the transform */
+void
+SpectralFieldData::BackwardTransformDistributed (MultiFab& mf, const int field_index,
+                                                 const int i_comp)
+{
+    // Check field index type, in order to apply proper shift in spectral space
+    const bool is_nodal_x = mf.is_nodal(0);
+#if (AMREX_SPACEDIM == 3)
+    const bool is_nodal_y = mf.is_nodal(1);
+    const bool is_nodal_z = mf.is_nodal(2);
+#else
+    const bool is_nodal_z = mf.is_nodal(1);
+#endif
+
+    // Copy the appropriate index of `fields` to the array of the FFT library
+    // and apply correcting shift factor (see BackwardTransform)
+    for ( MFIter mfi(fields); mfi.isValid(); ++mfi ){
+        const Box& spectralspace_bx = mfi.validbox();
+        const Dim3 hi = amrex::ubound(spectralspace_bx);
+        Array4<Complex> tmp_arr(m_distributed_complex.data(),
+                                amrex::lbound(spectralspace_bx),
+                                Dim3{hi.x+1, hi.y+1, hi.z+1}, 1);
+        Array4<const Complex> field_arr = fields.const_array(mfi);
+        const Complex* xshift_arr = xshift_FFTtoCell[mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+        const Complex* yshift_arr = yshift_FFTtoCell[mfi].dataPtr();
+#endif
+        const Complex* zshift_arr = zshift_FFTtoCell[mfi].dataPtr();
+
+        ParallelFor( spectralspace_bx,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            Complex spectral_field_value = field_arr(i,j,k,field_index);
+            // Apply proper shift in each dimension
+            if (is_nodal_x==false) spectral_field_value *= xshift_arr[i];
+#if (AMREX_SPACEDIM == 3)
+            if (is_nodal_y==false) spectral_field_value *= yshift_arr[j];
+            if (is_nodal_z==false) spectral_field_value *= zshift_arr[k];
+#elif (AMREX_SPACEDIM == 2)
+            if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
+#endif
+            // Copy field into temporary array
+            tmp_arr(i,j,k) = spectral_field_value;
+        });
+    }
+
+    // Perform the distributed Fourier transform
+    // (collective over all MPI ranks, including those without a slab)
+    AnyFFT::Execute(m_distributed_plans[1]);
+
+    // Copy the padded array of the FFT library to the local slab
+    const Dim3 nreal = amrex::length(m_fft_domain);
+    const int nx_padded = 2*(nreal.x/2 + 1);
+    for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
+        const Box& bx = mfi.validbox();
+        const Dim3 lo = amrex::lbound(bx);
+        const Dim3 hi = amrex::ubound(bx);
+        Array4<const Real> padded_arr(m_distributed_real.data(), lo,
+                                      Dim3{lo.x+nx_padded, hi.y+1, hi.z+1}, 1);
+        Array4<Real> tmp_arr = tmpRealField.array(mfi);
+        ParallelFor( bx,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            tmp_arr(i,j,k) = padded_arr(i,j,k);
+        });
+    }
+
+    // Scatter the slabs back to the boxes of `mf` (all-to-all communication).
+    // One guard cell is filled, with periodicity, so that the last point
+    // of `mf` in the directions with *nodal* index type is also set.
+    MultiFab mf_cell(amrex::convert(mf.boxArray(), IntVect::TheCellVector()),
+                     mf.DistributionMap(), 1, 1);
+    mf_cell.ParallelCopy(tmpRealField, 0, 0, 1, IntVect(0), IntVect(1),
+                         Periodicity(m_fft_domain.length()));
+
+    // Copy to the valid cells of `mf` and normalize
+    // (divide by 1/N since the FFT+IFFT results in a factor N)
+    const Real inv_N = 1._rt/m_fft_domain.numPts();
+    for ( MFIter mfi(mf); mfi.isValid(); ++mfi ){
+        Array4<Real> mf_arr = mf.array(mfi);
+        Array4<const Real> cell_arr = mf_cell.const_array(mfi);
+        ParallelFor( mfi.validbox(),
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            mf_arr(i,j,k,i_comp) = inv_N*cell_arr(i,j,k);
+        });
+    }
+}
+
 #endif // WARPX_USE_PSATD
@@ -7,6 +7,7 @@
 #include "SpectralFieldDataRZ.H"
 
 #include "WarpX.H"
+#include "Parallelization/WarpXCommUtil.H"
 
 using amrex::operator""_rt;
 
@@ -18,17 +19,52 @@ using amrex::operator""_rt;
  * \param dm Indicates which MPI proc owns which box, in realspace_ba
  * \param n_field_required Specifies the number of fields that will be transformed
  * \param n_modes Number of cylindrical modes
+ * \param lev Mesh refinement level
+ * \param distributed_hankel Whether the boxes may hold only part of the radial grid,
+ *  in which case the Hankel transforms are distributed among the boxes
  * */
 SpectralFieldDataRZ::SpectralFieldDataRZ (amrex::BoxArray const & realspace_ba,
                                           SpectralKSpaceRZ const & k_space,
                                           amrex::DistributionMapping const & dm,
                                           int const n_field_required,
                                           int const n_modes,
-                                          int const lev)
-    : n_rz_azimuthal_modes(n_modes)
+                                          int const lev,
+                                          bool const distributed_hankel)
+    : n_rz_azimuthal_modes(n_modes), m_distributed_hankel(distributed_hankel)
 {
     amrex::BoxArray const & spectralspace_ba = k_space.spectralspace_ba;
 
+    amrex::Geometry const & geom = WarpX::GetInstance().Geom(lev);
+    amrex::Box const & domain = geom.Domain();
+
+    if (m_distributed_hankel) {
+        // The Hankel transform of each box is computed from its block of
+        // the radial grid, and the partial transforms of the boxes are then
+        // summed. Each point must only be counted once, so the sum is done
+        // on the valid boxes, whose guard cells along z are filled afterwards.
+        // (realspace_ba includes the guard cells of E along z.)
+        int const ngz = WarpX::GetInstance().getngE()[1];
+        amrex::BoxList hankel_bl;
+        amrex::BoxList hankel_full_bl;
+        for (int i = 0; i < realspace_ba.size(); ++i) {
+            amrex::Box bx = amrex::grow(realspace_ba[i], 1, -ngz);
+            if (!geom.isPeriodic(1)) {
+                // The guard cells outside of the domain are not filled by
+                // the other boxes: they are transformed with the valid cells
+                if (bx.smallEnd(1) == domain.smallEnd(1)) bx.growLo(1, ngz);
+                if (bx.bigEnd(1) == domain.bigEnd(1)) bx.growHi(1, ngz);
+            }
+            hankel_bl.push_back(bx);
+            bx.setSmall(0, domain.smallEnd(0));
+            bx.setBig(0, domain.bigEnd(0));
+            hankel_full_bl.push_back(bx);
+        }
+        m_hankel_ba = amrex::BoxArray(std::move(hankel_bl));
+        m_hankel_full_ba = amrex::BoxArray(std::move(hankel_full_bl));
+        m_hankel_ngrow = amrex::IntVect(AMREX_D_DECL(0, ngz, 0));
+        m_period = geom.periodicity();
+    }
+
     // Allocate the arrays that contain the fields in spectral space.
     // SpectralField is comparable to a MultiFab but stores complex numbers.
     // This stores all of the transformed fields in one place, with the last dimension
@@ -170,8 +206,16 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (amrex::BoxArray const & realspace_ba,
 #endif
 
         // Create the Hankel transformer for each box.
-        std::array<amrex::Real,3> xmax = WarpX::UpperCorner(mfi.tilebox(), lev);
-        multi_spectral_hankel_transformer[mfi] = SpectralHankelTransformer(grid_size[0], n_rz_azimuthal_modes, xmax[0]);
+        if (m_distributed_hankel) {
+            // The box holds the radial points [ir_start, ir_start+nr_local) of the domain
+            std::array<amrex::Real,3> xmax = WarpX::UpperCorner(domain, lev);
+            int const ir_start = realspace_ba[mfi].smallEnd(0) - domain.smallEnd(0);
+            multi_spectral_hankel_transformer[mfi] = SpectralHankelTransformer(domain.length(0), n_rz_azimuthal_modes,
+                                                                               xmax[0], ir_start, grid_size[0]);
+        } else {
+            std::array<amrex::Real,3> xmax = WarpX::UpperCorner(mfi.tilebox(), lev);
+            multi_spectral_hankel_transformer[mfi] = SpectralHankelTransformer(grid_size[0], n_rz_azimuthal_modes, xmax[0]);
+        }
     }
 }
 
@@ -415,6 +459,29 @@ SpectralFieldDataRZ::ForwardTransform (amrex::MultiFab const & field_mf, int con
     // A full multifab is created so that each GPU stream has its own temp space.
     amrex::MultiFab tempHTransformedSplit(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
 
+    if (m_distributed_hankel) {
+        // Each box transforms its radial block, over the full spectral grid,
+        // and the partial transforms are summed.
+        amrex::MultiFab field_mf_block(m_hankel_ba, field_mf.DistributionMap(), ncomp, 0);
+        amrex::MultiFab partial(m_hankel_full_ba, field_mf.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        for (amrex::MFIter mfi(field_mf); mfi.isValid(); ++mfi){
+            if ( !(field_mf[mfi].box().contains(field_mf_block[mfi].box())) ) {
+                field_mf_block[mfi].setVal<amrex::RunOn::Device>(0._rt, field_mf_block[mfi].box(), 0, ncomp);
+            }
+            field_mf_block[mfi].copy<amrex::RunOn::Device>(field_mf[mfi], i_comp*ncomp, 0, ncomp);
+            multi_spectral_hankel_transformer[mfi].PhysicalToSpectral_Scalar(field_mf_block[mfi], partial[mfi]);
+        }
+        amrex::MultiFab transformed(m_hankel_ba, field_mf.DistributionMap(), 2*n_rz_azimuthal_modes, m_hankel_ngrow);
+        SumRadialBlocks(partial, transformed);
+
+        for (amrex::MFIter mfi(field_mf); mfi.isValid(); ++mfi){
+            amrex::Box const& realspace_bx = tempHTransformed[mfi].box();
+            tempHTransformedSplit[mfi].copy<amrex::RunOn::Device>(transformed[mfi], 0, 0, 2*n_rz_azimuthal_modes);
+            FABZForwardTransform(mfi, realspace_bx, tempHTransformedSplit, field_index, is_nodal_z);
+        }
+        return;
+    }
+
     // Loop over boxes.
     for (amrex::MFIter mfi(field_mf); mfi.isValid(); ++mfi){
 
@@ -456,6 +523,45 @@ SpectralFieldDataRZ::ForwardTransform (amrex::MultiFab const & field_mf_r, int c
     amrex::MultiFab tempHTransformedSplit_p(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
     amrex::MultiFab tempHTransformedSplit_m(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
 
+    if (m_distributed_hankel) {
+        // Each box transforms its radial block, over the full spectral grid,
+        // and the partial transforms are summed.
+        amrex::MultiFab field_mf_r_block(m_hankel_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        amrex::MultiFab field_mf_t_block(m_hankel_ba, field_mf_t.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        amrex::MultiFab partial_p(m_hankel_full_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        amrex::MultiFab partial_m(m_hankel_full_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        for (amrex::MFIter mfi(field_mf_r); mfi.isValid(); ++mfi){
+            amrex::Box const& block_bx = field_mf_r_block[mfi].box();
+            if ( !(field_mf_r[mfi].box().contains(block_bx)) ) {
+                field_mf_r_block[mfi].setVal<amrex::RunOn::Device>(0._rt, block_bx, 0, 2*n_rz_azimuthal_modes);
+                field_mf_t_block[mfi].setVal<amrex::RunOn::Device>(0._rt, block_bx, 0, 2*n_rz_azimuthal_modes);
+            }
+            field_mf_r_block[mfi].copy<amrex::RunOn::Device>(field_mf_r[mfi], 0, 0, 1); // Real part of mode 0
+            field_mf_t_block[mfi].copy<amrex::RunOn::Device>(field_mf_t[mfi], 0, 0, 1); // Real part of mode 0
+            field_mf_r_block[mfi].setVal<amrex::RunOn::Device>(0._rt, block_bx, 1, 1); // Imaginary part of mode 0
+            field_mf_t_block[mfi].setVal<amrex::RunOn::Device>(0._rt, block_bx, 1, 1); // Imaginary part of mode 0
+            field_mf_r_block[mfi].copy<amrex::RunOn::Device>(field_mf_r[mfi], 1, 2, 2*n_rz_azimuthal_modes-2);
+            field_mf_t_block[mfi].copy<amrex::RunOn::Device>(field_mf_t[mfi], 1, 2, 2*n_rz_azimuthal_modes-2);
+
+            multi_spectral_hankel_transformer[mfi].PhysicalToSpectral_Vector(block_bx,
+                                                               field_mf_r_block[mfi], field_mf_t_block[mfi],
+                                                               partial_p[mfi], partial_m[mfi]);
+        }
+        amrex::MultiFab transformed_p(m_hankel_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, m_hankel_ngrow);
+        amrex::MultiFab transformed_m(m_hankel_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, m_hankel_ngrow);
+        SumRadialBlocks(partial_p, transformed_p);
+        SumRadialBlocks(partial_m, transformed_m);
+
+        for (amrex::MFIter mfi(field_mf_r); mfi.isValid(); ++mfi){
+            amrex::Box const& realspace_bx = tempHTransformed[mfi].box();
+            tempHTransformedSplit_p[mfi].copy<amrex::RunOn::Device>(transformed_p[mfi], 0, 0, 2*n_rz_azimuthal_modes);
+            tempHTransformedSplit_m[mfi].copy<amrex::RunOn::Device>(transformed_m[mfi], 0, 0, 2*n_rz_azimuthal_modes);
+            FABZForwardTransform(mfi, realspace_bx, tempHTransformedSplit_p, field_index_r, is_nodal_z);
+            FABZForwardTransform(mfi, realspace_bx, tempHTransformedSplit_m, field_index_t, is_nodal_z);
+        }
+        return;
+    }
+
     // Loop over boxes.
     for (amrex::MFIter mfi(field_mf_r); mfi.isValid(); ++mfi){
 
@@ -503,6 +609,27 @@ SpectralFieldDataRZ::BackwardTransform (amrex::MultiFab& field_mf, int const fie
     // This allows the final result to have a different shape than the transformed field.
     amrex::MultiFab field_mf_copy(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes-1, 0);
 
+    if (m_distributed_hankel) {
+        // Each box transforms its spectral block, over the full radial grid,
+        // and the partial transforms are summed.
+        amrex::MultiFab spectral_block(m_hankel_ba, field_mf.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        amrex::MultiFab partial(m_hankel_full_ba, field_mf.DistributionMap(), ncomp, 0);
+        for (amrex::MFIter mfi(field_mf); mfi.isValid(); ++mfi){
+            amrex::Box const& realspace_bx = tempHTransformed[mfi].box();
+            FABZBackwardTransform(mfi, realspace_bx, field_index, tempHTransformedSplit, is_nodal_z);
+            spectral_block[mfi].copy<amrex::RunOn::Device>(tempHTransformedSplit[mfi], 0, 0, 2*n_rz_azimuthal_modes);
+            multi_spectral_hankel_transformer[mfi].SpectralToPhysical_Scalar(spectral_block[mfi], partial[mfi]);
+        }
+        amrex::MultiFab transformed(m_hankel_ba, field_mf.DistributionMap(), ncomp, m_hankel_ngrow);
+        SumRadialBlocks(partial, transformed);
+
+        for (amrex::MFIter mfi(field_mf); mfi.isValid(); ++mfi){
+            amrex::Box const bx = tempHTransformed[mfi].box() & field_mf[mfi].box();
+            field_mf[mfi].copy<amrex::RunOn::Device>(transformed[mfi], bx, 0, bx, i_comp*ncomp, ncomp);
+        }
+        return;
+    }
+
     // Loop over boxes.
     for (amrex::MFIter mfi(field_mf); mfi.isValid(); ++mfi){
 
@@ -536,20 +663,49 @@ SpectralFieldDataRZ::BackwardTransform (amrex::MultiFab& field_mf_r, int const f
     amrex::MultiFab field_mf_r_copy(tempHTransformed.boxArray(), field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
     amrex::MultiFab field_mf_t_copy(tempHTransformed.boxArray(), field_mf_t.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
 
+    if (m_distributed_hankel) {
+        // Each box transforms its spectral block, over the full radial grid,
+        // and the partial transforms are summed.
+        amrex::MultiFab spectral_block_p(m_hankel_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        amrex::MultiFab spectral_block_m(m_hankel_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        amrex::MultiFab partial_r(m_hankel_full_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        amrex::MultiFab partial_t(m_hankel_full_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+        for (amrex::MFIter mfi(field_mf_r); mfi.isValid(); ++mfi){
+            amrex::Box const& realspace_bx = tempHTransformed[mfi].box();
+            FABZBackwardTransform(mfi, realspace_bx, field_index_r, tempHTransformedSplit_p, is_nodal_z);
+            FABZBackwardTransform(mfi, realspace_bx, field_index_t, tempHTransformedSplit_m, is_nodal_z);
+            spectral_block_p[mfi].copy<amrex::RunOn::Device>(tempHTransformedSplit_p[mfi], 0, 0, 2*n_rz_azimuthal_modes);
+            spectral_block_m[mfi].copy<amrex::RunOn::Device>(tempHTransformedSplit_m[mfi], 0, 0, 2*n_rz_azimuthal_modes);
+            multi_spectral_hankel_transformer[mfi].SpectralToPhysical_Vector(partial_r[mfi].box(),
+                                                               spectral_block_p[mfi], spectral_block_m[mfi],
+                                                               partial_r[mfi], partial_t[mfi]);
+        }
+        amrex::MultiFab transformed_r(m_hankel_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, m_hankel_ngrow);
+        amrex::MultiFab transformed_t(m_hankel_ba, field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, m_hankel_ngrow);
+        SumRadialBlocks(partial_r, transformed_r);
+        SumRadialBlocks(partial_t, transformed_t);
+        for (amrex::MFIter mfi(field_mf_r); mfi.isValid(); ++mfi){
+            field_mf_r_copy[mfi].copy<amrex::RunOn::Device>(transformed_r[mfi], 0, 0, 2*n_rz_azimuthal_modes);
+            field_mf_t_copy[mfi].copy<amrex::RunOn::Device>(transformed_t[mfi], 0, 0, 2*n_rz_azimuthal_modes);
+        }
+    }
+
     // Loop over boxes.
     for (amrex::MFIter mfi(field_mf_r); mfi.isValid(); ++mfi){
 
         amrex::Box const& realspace_bx = tempHTransformed[mfi].box();
 
-        FABZBackwardTransform(mfi, realspace_bx, field_index_r, tempHTransformedSplit_p, is_nodal_z);
-        FABZBackwardTransform(mfi, realspace_bx, field_index_t, tempHTransformedSplit_m, is_nodal_z);
+        if (!m_distributed_hankel) {
+            FABZBackwardTransform(mfi, realspace_bx, field_index_r, tempHTransformedSplit_p, is_nodal_z);
+            FABZBackwardTransform(mfi, realspace_bx, field_index_t, tempHTransformedSplit_m, is_nodal_z);
 
-        // Perform the Hankel inverse transform last.
-        // tempHTransformedSplit includes the imaginary component of mode 0.
-        // field_mf_[ri] do not.
-        multi_spectral_hankel_transformer[mfi].SpectralToPhysical_Vector(realspace_bx,
-                                                           tempHTransformedSplit_p[mfi], tempHTransformedSplit_m[mfi],
-                                                           field_mf_r_copy[mfi], field_mf_t_copy[mfi]);
+            // Perform the Hankel inverse transform last.
+            // tempHTransformedSplit includes the imaginary component of mode 0.
+            // field_mf_[ri] do not.
+            multi_spectral_hankel_transformer[mfi].SpectralToPhysical_Vector(realspace_bx,
+                                                               tempHTransformedSplit_p[mfi], tempHTransformedSplit_m[mfi],
+                                                               field_mf_r_copy[mfi], field_mf_t_copy[mfi]);
+        }
 
         amrex::Array4<amrex::Real> const & field_mf_r_array = field_mf_r[mfi].array();
         amrex::Array4<amrex::Real> const & field_mf_t_array = field_mf_t[mfi].array();
@@ -572,6 +728,21 @@ SpectralFieldDataRZ::BackwardTransform (amrex::MultiFab& field_mf_r, int const f
 
 }
 
+/* \brief Sum the partial Hankel transforms of the radial blocks
+ *
+ * The boxes of m_hankel_full_ba that cover the same range along z overlap
+ * over the full radial grid, so the sum of their partial transforms is added
+ * into the box of m_hankel_ba that owns the corresponding radial block.
+ * The guard cells along z, which belong to the neighboring boxes, are then filled. */
+void
+SpectralFieldDataRZ::SumRadialBlocks (amrex::MultiFab const & partial, amrex::MultiFab & result) const
+{
+    result.setVal(0._rt);
+    WarpXCommUtil::ParallelAdd(result, partial, 0, 0, partial.nComp(),
+                               amrex::IntVect(0), amrex::IntVect(0), amrex::Periodicity::NonPeriodic());
+    WarpXCommUtil::FillBoundary(result, m_period);
+}
+
 /* \brief Initialize arrays used for filtering */
 void
 SpectralFieldDataRZ::InitFilter (amrex::IntVect const & filter_npass_each_dir, bool const compensation,
@@ -12,8 +12,40 @@
 #include <blas.hh>
 #include <lapack.hh>
 
+#include <map>
+#include <tuple>
+
 using amrex::operator""_rt;
 
+namespace {
+    // Transforms, keyed on (hankel_order, azimuthal_mode, nr, rmax)
+    std::map<std::tuple<int,int,int,amrex::Real>,
+             std::shared_ptr<HankelTransform const> > hankel_transform_cache;
+}
+
+std::shared_ptr<HankelTransform const>
+HankelTransform::GetHankelTransform (int const hankel_order,
+                                     int const azimuthal_mode,
+                                     int const nr,
+                                     const amrex::Real rmax)
+{
+    if (hankel_transform_cache.empty()) {
+        amrex::ExecOnFinalize(HankelTransform::ClearCache);
+    }
+    auto const key = std::make_tuple(hankel_order, azimuthal_mode, nr, rmax);
+    auto& transform = hankel_transform_cache[key];
+    if (!transform) {
+        transform = std::make_shared<HankelTransform const>(hankel_order, azimuthal_mode, nr, rmax);
+    }
+    return transform;
+}
+
+void
+HankelTransform::ClearCache ()
+{
+    hankel_transform_cache.clear();
+}
+
 HankelTransform::HankelTransform (int const hankel_order,
                                   int const azimuthal_mode,
                                   int const nr,
@@ -182,7 +214,8 @@ HankelTransform::HankelTransform (int const hankel_order,
 
 void
 HankelTransform::HankelForwardTransform (amrex::FArrayBox const& F, int const F_icomp,
-                                         amrex::FArrayBox      & G, int const G_icomp)
+                                         amrex::FArrayBox      & G, int const G_icomp,
+                                         int const ncomp) const
 {
     amrex::Box const& F_box = F.box();
     amrex::Box const& G_box = G.box();
@@ -200,8 +233,10 @@ HankelTransform::HankelForwardTransform (amrex::FArrayBox const& F, int const F_
     // On CPU, the blas::gemm is significantly faster
 
     // Note that M is flagged to be transposed since it has dimensions (m_nr, m_nk)
+    // Since the components are contiguous in the FArrayBox, the ncomp components
+    // are transformed together, as a matrix with ncomp*nz columns
     blas::gemm(blas::Layout::ColMajor, blas::Op::Trans, blas::Op::NoTrans,
-               m_nk, nz, m_nr, 1._rt,
+               m_nk, ncomp*nz, m_nr, 1._rt,
                m_M.dataPtr(), m_nk,
                F.dataPtr(F_icomp)+ngr, nrF, 0._rt,
                G.dataPtr(G_icomp), m_nk);
@@ -217,12 +252,12 @@ HankelTransform::HankelForwardTransform (amrex::FArrayBox const& F, int const F_
 
     int const nr = m_nr;
 
-    amrex::ParallelFor(G_box,
-    [=] AMREX_GPU_DEVICE(int ik, int iz, int inotused) noexcept {
-        G_arr(ik,iz,G_icomp) = 0.;
+    amrex::ParallelFor(G_box, ncomp,
+    [=] AMREX_GPU_DEVICE(int ik, int iz, int inotused, int n) noexcept {
+        G_arr(ik,iz,G_icomp+n) = 0.;
         for (int ir=0 ; ir < nr ; ir++) {
             int const ii = ir + ik*nr;
-            G_arr(ik,iz,G_icomp) += M_arr[ii]*F_arr(ir,iz,F_icomp);
+            G_arr(ik,iz,G_icomp+n) += M_arr[ii]*F_arr(ir,iz,F_icomp+n);
         }
     });
 
@@ -232,7 +267,8 @@ HankelTransform::HankelForwardTransform (amrex::FArrayBox const& F, int const F_
 
 void
 HankelTransform::HankelInverseTransform (amrex::FArrayBox const& G, int const G_icomp,
-                                         amrex::FArrayBox      & F, int const F_icomp)
+                                         amrex::FArrayBox      & F, int const F_icomp,
+                                         int const ncomp) const
 {
     amrex::Box const& G_box = G.box();
     amrex::Box const& F_box = F.box();
@@ -250,8 +286,10 @@ HankelTransform::HankelInverseTransform (amrex::FArrayBox const& G, int const G_
     // On CPU, the blas::gemm is significantly faster
 
     // Note that m_invM is flagged to be transposed since it has dimensions (m_nk, m_nr)
+    // Since the components are contiguous in the FArrayBox, the ncomp components
+    // are transformed together, as a matrix with ncomp*nz columns
     blas::gemm(blas::Layout::ColMajor, blas::Op::Trans, blas::Op::NoTrans,
-               m_nr, nz, m_nk, 1._rt,
+               m_nr, ncomp*nz, m_nk, 1._rt,
                m_invM.dataPtr(), m_nr,
                G.dataPtr(G_icomp), m_nk, 0._rt,
                F.dataPtr(F_icomp)+ngr, nrF);
@@ -267,12 +305,102 @@ HankelTransform::HankelInverseTransform (amrex::FArrayBox const& G, int const G_
 
     int const nk = m_nk;
 
-    amrex::ParallelFor(G_box,
-    [=] AMREX_GPU_DEVICE(int ir, int iz, int inotused) noexcept {
-        F_arr(ir,iz,F_icomp) = 0.;
+    amrex::ParallelFor(G_box, ncomp,
+    [=] AMREX_GPU_DEVICE(int ir, int iz, int inotused, int n) noexcept {
+        F_arr(ir,iz,F_icomp+n) = 0.;
         for (int ik=0 ; ik < nk ; ik++) {
             int const ii = ik + ir*nk;
-            F_arr(ir,iz,F_icomp) += invM_arr[ii]*G_arr(ik,iz,G_icomp);
+            F_arr(ir,iz,F_icomp+n) += invM_arr[ii]*G_arr(ik,iz,G_icomp+n);
+        }
+    });
+
+#endif
+
+}
+
+void
+HankelTransform::HankelForwardTransformBlock (amrex::FArrayBox const& F, int const F_icomp,
+                                              amrex::FArrayBox      & G, int const G_icomp,
+                                              int const ir_start, int const ncomp) const
+{
+    amrex::Box const& F_box = F.box();
+    amrex::Box const& G_box = G.box();
+
+    int const nb = F_box.length(0);
+    int const nz = F_box.length(1);
+
+    AMREX_ALWAYS_ASSERT(ir_start >= 0 && ir_start + nb <= m_nr);
+    AMREX_ALWAYS_ASSERT(m_nk == G_box.length(0));
+    AMREX_ALWAYS_ASSERT(nz == G_box.length(1));
+
+#ifndef AMREX_USE_GPU
+    // Only the rows ir_start to ir_start+nb-1 of M contribute
+    blas::gemm(blas::Layout::ColMajor, blas::Op::Trans, blas::Op::NoTrans,
+               m_nk, ncomp*nz, nb, 1._rt,
+               m_M.dataPtr()+ir_start, m_nr,
+               F.dataPtr(F_icomp), nb, 0._rt,
+               G.dataPtr(G_icomp), m_nk);
+
+#else
+
+    amrex::Real const * M_arr = m_M.dataPtr();
+    amrex::Array4<const amrex::Real> const & F_arr = F.array();
+    amrex::Array4<      amrex::Real> const & G_arr = G.array();
+
+    int const nr = m_nr;
+    int const F_r0 = F_box.smallEnd(0);
+
+    amrex::ParallelFor(G_box, ncomp,
+    [=] AMREX_GPU_DEVICE(int ik, int iz, int inotused, int n) noexcept {
+        G_arr(ik,iz,G_icomp+n) = 0.;
+        for (int ib=0 ; ib < nb ; ib++) {
+            int const ii = ir_start + ib + ik*nr;
+            G_arr(ik,iz,G_icomp+n) += M_arr[ii]*F_arr(F_r0+ib,iz,F_icomp+n);
+        }
+    });
+
+#endif
+
+}
+
+void
+HankelTransform::HankelInverseTransformBlock (amrex::FArrayBox const& G, int const G_icomp,
+                                              amrex::FArrayBox      & F, int const F_icomp,
+                                              int const ik_start, int const ncomp) const
+{
+    amrex::Box const& G_box = G.box();
+    amrex::Box const& F_box = F.box();
+
+    int const nb = G_box.length(0);
+    int const nz = G_box.length(1);
+
+    AMREX_ALWAYS_ASSERT(ik_start >= 0 && ik_start + nb <= m_nk);
+    AMREX_ALWAYS_ASSERT(m_nr == F_box.length(0));
+    AMREX_ALWAYS_ASSERT(nz == F_box.length(1));
+
+#ifndef AMREX_USE_GPU
+    // Only the rows ik_start to ik_start+nb-1 of invM contribute
+    blas::gemm(blas::Layout::ColMajor, blas::Op::Trans, blas::Op::NoTrans,
+               m_nr, ncomp*nz, nb, 1._rt,
+               m_invM.dataPtr()+ik_start, m_nk,
+               G.dataPtr(G_icomp), nb, 0._rt,
+               F.dataPtr(F_icomp), m_nr);
+
+#else
+
+    amrex::Real const * invM_arr = m_invM.dataPtr();
+    amrex::Array4<const amrex::Real> const & G_arr = G.array();
+    amrex::Array4<      amrex::Real> const & F_arr = F.array();
+
+    int const nk = m_nk;
+    int const G_k0 = G_box.smallEnd(0);
+
+    amrex::ParallelFor(F_box, ncomp,
+    [=] AMREX_GPU_DEVICE(int ir, int iz, int inotused, int n) noexcept {
+        F_arr(ir,iz,F_icomp+n) = 0.;
+        for (int ib=0 ; ib < nb ; ib++) {
+            int const ii = ik_start + ib + ir*nk;
+            F_arr(ir,iz,F_icomp+n) += invM_arr[ii]*G_arr(G_k0+ib,iz,G_icomp+n);
         }
     });
 
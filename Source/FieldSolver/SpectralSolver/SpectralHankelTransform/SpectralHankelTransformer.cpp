@@ -12,17 +12,27 @@
 SpectralHankelTransformer::SpectralHankelTransformer (int const nr,
                                                       int const n_rz_azimuthal_modes,
                                                       amrex::Real const rmax)
-: m_nr(nr), m_n_rz_azimuthal_modes(n_rz_azimuthal_modes)
+: SpectralHankelTransformer(nr, n_rz_azimuthal_modes, rmax, 0, nr)
+{}
+
+SpectralHankelTransformer::SpectralHankelTransformer (int const nr,
+                                                      int const n_rz_azimuthal_modes,
+                                                      amrex::Real const rmax,
+                                                      int const ir_start,
+                                                      int const nr_local)
+: m_nr(nr), m_n_rz_azimuthal_modes(n_rz_azimuthal_modes),
+  m_ir_start(ir_start), m_nr_local(nr_local)
 {
+    AMREX_ALWAYS_ASSERT(m_ir_start >= 0 && m_ir_start + m_nr_local <= m_nr);
 
     dht0.resize(m_n_rz_azimuthal_modes);
     dhtp.resize(m_n_rz_azimuthal_modes);
     dhtm.resize(m_n_rz_azimuthal_modes);
 
     for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
-        dht0[mode] = std::make_unique<HankelTransform>(mode  , mode, m_nr, rmax);
-        dhtp[mode] = std::make_unique<HankelTransform>(mode+1, mode, m_nr, rmax);
-        dhtm[mode] = std::make_unique<HankelTransform>(mode-1, mode, m_nr, rmax);
+        dht0[mode] = HankelTransform::GetHankelTransform(mode  , mode, m_nr, rmax);
+        dhtp[mode] = HankelTransform::GetHankelTransform(mode+1, mode, m_nr, rmax);
+        dhtm[mode] = HankelTransform::GetHankelTransform(mode-1, mode, m_nr, rmax);
     }
 
     ExtractKrArray();
@@ -34,34 +44,66 @@ SpectralHankelTransformer::SpectralHankelTransformer (int const nr,
 void
 SpectralHankelTransformer::ExtractKrArray ()
 {
-    m_kr.resize(m_nr*m_n_rz_azimuthal_modes);
+    m_kr.resize(m_nr_local*m_n_rz_azimuthal_modes);
 
     for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
 
         // Save a copy of all of the kr's in one place to allow easy access later.
         // They are stored with the kr's of each mode grouped together.
+        // Only the kr's of the block of the box are kept.
         amrex::Real *kr_array = m_kr.dataPtr();
         auto const & kr_mode = dht0[mode]->getSpectralWavenumbers();
         auto const & kr_m_array = kr_mode.dataPtr();
-        int const nr_temp = m_nr;
-        amrex::ParallelFor(m_nr,
+        int const nr_temp = m_nr_local;
+        int const ir_start = m_ir_start;
+        amrex::ParallelFor(m_nr_local,
         [=] AMREX_GPU_DEVICE (int ir)
         {
             int const ii = ir + mode*nr_temp;
-            kr_array[ii] = kr_m_array[ir];
+            kr_array[ii] = kr_m_array[ir + ir_start];
         });
     }
     amrex::Gpu::synchronize();
 }
 
+/* \brief Forward transform with the transform dht, over the whole radial grid
+ * or over the radial block of the box when the solver is radially distributed */
+void
+SpectralHankelTransformer::ForwardTransform (HankelTransform const & dht,
+                                             amrex::FArrayBox const & F, int const F_icomp,
+                                             amrex::FArrayBox       & G, int const G_icomp,
+                                             int const ncomp) const
+{
+    if (m_nr_local < m_nr) {
+        dht.HankelForwardTransformBlock(F, F_icomp, G, G_icomp, m_ir_start, ncomp);
+    } else {
+        dht.HankelForwardTransform(F, F_icomp, G, G_icomp, ncomp);
+    }
+}
+
+/* \brief Inverse transform with the transform dht, over the whole spectral grid
+ * or over the spectral block of the box when the solver is radially distributed */
+void
+SpectralHankelTransformer::InverseTransform (HankelTransform const & dht,
+                                             amrex::FArrayBox const & G, int const G_icomp,
+                                             amrex::FArrayBox       & F, int const F_icomp,
+                                             int const ncomp) const
+{
+    if (m_nr_local < m_nr) {
+        dht.HankelInverseTransformBlock(G, G_icomp, F, F_icomp, m_ir_start, ncomp);
+    } else {
+        dht.HankelInverseTransform(G, G_icomp, F, F_icomp, ncomp);
+    }
+}
+
 /* \brief Converts a scalar field from the physical to the spectral space for all modes */
 void
 SpectralHankelTransformer::PhysicalToSpectral_Scalar (amrex::FArrayBox const & F_physical,
                                                       amrex::FArrayBox       & G_spectral)
 {
     // The Hankel transform is purely real, so the real and imaginary parts of
-    // F can be transformed separately, so a simple loop over components
-    // can be done.
+    // F can be transformed separately. Since they are contiguous components,
+    // they are transformed together, with one matrix product per mode.
     // Note that F_physical does not include the imaginary part of mode 0,
     // but G_spectral does.
     for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
@@ -69,12 +111,11 @@ SpectralHankelTransformer::PhysicalToSpectral_Scalar (amrex::FArrayBox const & F
         int const mode_i = 2*mode + 1;
         if (mode == 0) {
             int const icomp = 0;
-            dht0[mode]->HankelForwardTransform(F_physical, icomp, G_spectral, mode_r);
+            ForwardTransform(*dht0[mode], F_physical, icomp, G_spectral, mode_r, 1);
             G_spectral.setVal<amrex::RunOn::Device>(0., mode_i);
         } else {
             int const icomp = 2*mode - 1;
-            dht0[mode]->HankelForwardTransform(F_physical, icomp  , G_spectral, mode_r);
-            dht0[mode]->HankelForwardTransform(F_physical, icomp+1, G_spectral, mode_i);
+            ForwardTransform(*dht0[mode], F_physical, icomp, G_spectral, mode_r, 2);
         }
     }
 }
@@ -118,10 +159,9 @@ SpectralHankelTransformer::PhysicalToSpectral_Vector (amrex::Box const & box,
 
         amrex::Gpu::streamSynchronize();
 
-        dhtp[mode]->HankelForwardTransform(F_r_physical, mode_r, G_p_spectral, mode_r);
-        dhtp[mode]->HankelForwardTransform(F_r_physical, mode_i, G_p_spectral, mode_i);
-        dhtm[mode]->HankelForwardTransform(F_t_physical, mode_r, G_m_spectral, mode_r);
-        dhtm[mode]->HankelForwardTransform(F_t_physical, mode_i, G_m_spectral, mode_i);
+        // The real and imaginary parts are transformed together
+        ForwardTransform(*dhtp[mode], F_r_physical, mode_r, G_p_spectral, mode_r, 2);
+        ForwardTransform(*dhtm[mode], F_t_physical, mode_r, G_m_spectral, mode_r, 2);
 
     }
 }
@@ -132,8 +172,8 @@ SpectralHankelTransformer::SpectralToPhysical_Scalar (amrex::FArrayBox const & G
                                                       amrex::FArrayBox       & F_physical)
 {
     // The Hankel inverse transform is purely real, so the real and imaginary parts of
-    // F can be transformed separately, so a simple loop over components
-    // can be done.
+    // F can be transformed separately. Since they are contiguous components,
+    // they are transformed together, with one matrix product per mode.
     // Note that F_physical does not include the imaginary part of mode 0,
     // but G_spectral does.
 
@@ -141,14 +181,12 @@ SpectralHankelTransformer::SpectralToPhysical_Scalar (amrex::FArrayBox const & G
 
     for (int mode=0 ; mode < m_n_rz_azimuthal_modes ; mode++) {
         int const mode_r = 2*mode;
-        int const mode_i = 2*mode + 1;
         if (mode == 0) {
             int const icomp = 0;
-            dht0[mode]->HankelInverseTransform(G_spectral, mode_r, F_physical, icomp);
+            InverseTransform(*dht0[mode], G_spectral, mode_r, F_physical, icomp, 1);
         } else {
             int const icomp = 2*mode - 1;
-            dht0[mode]->HankelInverseTransform(G_spectral, mode_r, F_physical, icomp);
-            dht0[mode]->HankelInverseTransform(G_spectral, mode_i, F_physical, icomp+1);
+            InverseTransform(*dht0[mode], G_spectral, mode_r, F_physical, icomp, 2);
         }
     }
 }
@@ -173,10 +211,9 @@ SpectralHankelTransformer::SpectralToPhysical_Vector (amrex::Box const & box,
 
         amrex::Gpu::streamSynchronize();
 
-        dhtp[mode]->HankelInverseTransform(G_p_spectral, mode_r, F_r_physical, mode_r);
-        dhtp[mode]->HankelInverseTransform(G_p_spectral, mode_i, F_r_physical, mode_i);
-        dhtm[mode]->HankelInverseTransform(G_m_spectral, mode_r, F_t_physical, mode_r);
-        dhtm[mode]->HankelInverseTransform(G_m_spectral, mode_i, F_t_physical, mode_i);
+        // The real and imaginary parts are transformed together
+        InverseTransform(*dhtp[mode], G_p_spectral, mode_r, F_r_physical, mode_r, 2);
+        InverseTransform(*dhtm[mode], G_m_spectral, mode_r, F_t_physical, mode_r, 2);
 
         amrex::Gpu::streamSynchronize();
 
@@ -18,11 +18,15 @@ using namespace amrex;
  * of the fields in real space (cell-centered ; includes guard cells)
  * \param dm Indicates which MPI proc owns which box, in realspace_ba.
  * \param realspace_dx Cell size of the grid in real space
+ * \param distributed_fft Whether `realspace_ba` holds the slabs of a single
+ * distributed FFT over the whole domain (instead of one local FFT per box)
  */
 SpectralKSpace::SpectralKSpace( const BoxArray& realspace_ba,
                                 const DistributionMapping& dm,
-                                const RealVect realspace_dx )
-    : dx(realspace_dx)  // Store the cell size as member `dx`
+                                const RealVect realspace_dx,
+                                const bool distributed_fft )
+    : dx(realspace_dx),  // Store the cell size as member `dx`
+      m_distributed_fft(distributed_fft)
 {
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
         realspace_ba.ixType()==IndexType::TheCellType(),
@@ -30,24 +34,38 @@ SpectralKSpace::SpectralKSpace( const BoxArray& realspace_ba,
 
     // Create the box array that corresponds to spectral space
     BoxList spectral_bl; // Create empty box list
-    // Loop over boxes and fill the box list
-    for (int i=0; i < realspace_ba.size(); i++ ) {
-        // For local FFTs, boxes in spectral space start at 0 in
-        // each direction and have the same number of points as the
-        // (cell-centered) real space box
-        Box realspace_bx = realspace_ba[i];
-        IntVect fft_size = realspace_bx.length();
-        // Because the spectral solver uses real-to-complex FFTs, we only
-        // need the positive k values along the fastest axis
-        // (first axis for AMReX Fortran-order arrays) in spectral space.
-        // This effectively reduces the size of the spectral space by half
-        // see e.g. the FFTW documentation for real-to-complex FFTs
-        IntVect spectral_bx_size = fft_size;
-        spectral_bx_size[0] = fft_size[0]/2 + 1;
-        // Define the corresponding box
-        Box spectral_bx = Box( IntVect::TheZeroVector(),
-                               spectral_bx_size - IntVect::TheUnitVector() );
-        spectral_bl.push_back( spectral_bx );
+    if (m_distributed_fft) {
+        // For a distributed FFT, the boxes in spectral space are the slabs
+        // of the global spectral space (which starts at 0), so that the
+        // k vectors below can be indexed with the global indices
+        const Box domain = realspace_ba.minimalBox();
+        fft_domain_size = domain.length();
+        for (int i=0; i < realspace_ba.size(); i++ ) {
+            Box spectral_bx = amrex::shift(realspace_ba[i], -domain.smallEnd());
+            spectral_bx.setSmall(0, 0);
+            spectral_bx.setBig(0, fft_domain_size[0]/2);
+            spectral_bl.push_back( spectral_bx );
+        }
+    } else {
+        // Loop over boxes and fill the box list
+        for (int i=0; i < realspace_ba.size(); i++ ) {
+            // For local FFTs, boxes in spectral space start at 0 in
+            // each direction and have the same number of points as the
+            // (cell-centered) real space box
+            Box realspace_bx = realspace_ba[i];
+            IntVect fft_size = realspace_bx.length();
+            // Because the spectral solver uses real-to-complex FFTs, we only
+            // need the positive k values along the fastest axis
+            // (first axis for AMReX Fortran-order arrays) in spectral space.
+            // This effectively reduces the size of the spectral space by half
+            // see e.g. the FFTW documentation for real-to-complex FFTs
+            IntVect spectral_bx_size = fft_size;
+            spectral_bx_size[0] = fft_size[0]/2 + 1;
+            // Define the corresponding box
+            Box spectral_bx = Box( IntVect::TheZeroVector(),
+                                   spectral_bx_size - IntVect::TheUnitVector() );
+            spectral_bl.push_back( spectral_bx );
+        }
     }
     spectralspace_ba.define( spectral_bl );
 
@@ -83,17 +101,23 @@ SpectralKSpace::getKComponent( const DistributionMapping& dm,
         Gpu::DeviceVector<Real>& k = k_comp[mfi];
 
         // Allocate k to the right size
+        // (distributed FFT: the k vector covers the global spectral space)
         int N = bx.length( i_dim );
+        if (m_distributed_fft) {
+            N = only_positive_k ? fft_domain_size[i_dim]/2 + 1 : fft_domain_size[i_dim];
+        }
         k.resize( N );
         Real* pk = k.data();
 
         // Fill the k vector
-        IntVect fft_size = realspace_ba[mfi].length();
+        IntVect fft_size = m_distributed_fft ? fft_domain_size : realspace_ba[mfi].length();
         const Real dk = 2*MathConst::pi/(fft_size[i_dim]*dx[i_dim]);
-        AMREX_ALWAYS_ASSERT_WITH_MESSAGE( bx.smallEnd(i_dim) == 0,
-            "Expected box to start at 0, in spectral space.");
-        AMREX_ALWAYS_ASSERT_WITH_MESSAGE( bx.bigEnd(i_dim) == N-1,
-            "Expected different box end index in spectral space.");
+        if (!m_distributed_fft) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE( bx.smallEnd(i_dim) == 0,
+                "Expected box to start at 0, in spectral space.");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE( bx.bigEnd(i_dim) == N-1,
+                "Expected different box end index in spectral space.");
+        }
         if (only_positive_k){
             // Fill the full axis with positive k values
             // (typically: first axis, in a real-to-complex FFT)
@@ -0,0 +1,333 @@
+/* Copyright 2021
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "SpectralPoissonSolver.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXProfilerWrapper.H"
+
+#include <AMReX_ParallelDescriptor.H>
+
+#include <cmath>
+
+#if WARPX_USE_PSATD
+
+using namespace amrex;
+
+namespace
+{
+#if (AMREX_SPACEDIM == 3)
+    /** \brief Primitive of \f$1/r\f$ along x, y and z
+     *  (all arguments are expected to be positive) */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    double IGFPrimitive (double const x, double const y, double const z) noexcept
+    {
+        double const r = std::sqrt(x*x + y*y + z*z);
+        double F = 0.;
+        // Terms whose prefactor vanishes are skipped, to avoid log(0) and 0/0
+        if (y*z != 0.) F += y*z*std::log(x + r);
+        if (x*z != 0.) F += x*z*std::log(y + r);
+        if (x*y != 0.) F += x*y*std::log(z + r);
+        if (x != 0.) F -= 0.5*x*x*std::atan(y*z/(x*r));
+        if (y != 0.) F -= 0.5*y*y*std::atan(x*z/(y*r));
+        if (z != 0.) F -= 0.5*z*z*std::atan(x*y/(z*r));
+        return F;
+    }
+#else
+    /** \brief Primitive of \f$\ln(x^2+y^2)\f$ along x and y
+     *  (all arguments are expected to be positive) */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    double IGFPrimitive (double const x, double const y) noexcept
+    {
+        double F = 0.;
+        if (x*y != 0.) F += x*y*(std::log(x*x + y*y) - 3.);
+        if (x != 0.) F += x*x*std::atan(y/x);
+        if (y != 0.) F += y*y*std::atan(x/y);
+        return F;
+    }
+#endif
+
+    /** \brief Bounds of the cell centered on the node `i` (in units of
+     *  the cell size), restricted to positive values.
+     *  The Green's function is even, so the integral over the central cell
+     *  is twice the integral over its positive half. */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    void IGFCellBounds (int const i, double const dx,
+                        double& lo, double& hi, double& weight) noexcept
+    {
+        lo = (i == 0) ? 0. : (i - 0.5)*dx;
+        hi = (i + 0.5)*dx;
+        weight = (i == 0) ? 2. : 1.;
+    }
+}
+
+/* \brief Allocate the single-box buffers and the FFT plans
+ *
+ * \param geom Geometry of level 0
+ */
+SpectralPoissonSolver::SpectralPoissonSolver (const Geometry& geom)
+    : m_geom(geom)
+{
+    int n_periodic = 0;
+    for (int idim=0; idim<AMREX_SPACEDIM; idim++) {
+        if (geom.isPeriodic(idim)) n_periodic++;
+    }
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(n_periodic == 0 || n_periodic == AMREX_SPACEDIM,
+        "warpx.poisson_solver = fft requires a domain that is either "
+        "periodic or open along all directions.");
+    m_is_periodic = (n_periodic == AMREX_SPACEDIM);
+
+    // All the data is gathered in one box, owned by the I/O processor
+    const DistributionMapping dm_single{Vector<int>{ParallelDescriptor::IOProcessorNumber()}};
+    const Box& domain = geom.Domain();
+    const BoxArray ba_nodal( amrex::surroundingNodes(domain) );
+    m_rho_global = MultiFab(ba_nodal, dm_single, 1, 0);
+    m_phi_global = MultiFab(ba_nodal, dm_single, 1, 1);
+
+    // Periodic: the last node is identical to the first one and is discarded.
+    // Open: zero-padding (Hockney method), with two additional points so that
+    // the guard cell of phi on each side is not polluted by the periodic images.
+    const IntVect n_cells = domain.length();
+    for (int idim=0; idim<AMREX_SPACEDIM; idim++) {
+        m_fft_size[idim] = m_is_periodic ? n_cells[idim] : 2*(n_cells[idim]+1) + 2;
+    }
+    const BoxArray realspace_ba( Box(IntVect::TheZeroVector(),
+                                     m_fft_size - IntVect::TheUnitVector()) );
+    const RealVect dx(AMREX_D_DECL(geom.CellSize(0), geom.CellSize(1), geom.CellSize(2)));
+    const SpectralKSpace k_space(realspace_ba, dm_single, dx);
+    const BoxArray& spectralspace_ba = k_space.spectralspace_ba;
+
+    m_tmp_real = MultiFab(realspace_ba, dm_single, 1, 0);
+    m_tmp_spectral = SpectralField(spectralspace_ba, dm_single, 1, 0);
+    if (m_is_periodic) {
+        // Second-order, staggered modified k: this is the Fourier
+        // representation of the 3-point Laplacian used by the multigrid solver
+        for (int idim=0; idim<AMREX_SPACEDIM; idim++) {
+            m_modified_k[idim] = k_space.getModifiedKComponent(dm_single, idim, 2, false);
+        }
+    } else {
+        m_green_spectral = SpectralField(spectralspace_ba, dm_single, 1, 0);
+    }
+
+    m_forward_plan = AnyFFT::FFTplans(spectralspace_ba, dm_single);
+    m_backward_plan = AnyFFT::FFTplans(spectralspace_ba, dm_single);
+    for ( MFIter mfi(spectralspace_ba, dm_single); mfi.isValid(); ++mfi ){
+        m_forward_plan[mfi] = AnyFFT::CreatePlan(
+            m_fft_size, m_tmp_real[mfi].dataPtr(),
+            reinterpret_cast<AnyFFT::Complex*>( m_tmp_spectral[mfi].dataPtr()),
+            AnyFFT::direction::R2C, AMREX_SPACEDIM);
+        m_backward_plan[mfi] = AnyFFT::CreatePlan(
+            m_fft_size, m_tmp_real[mfi].dataPtr(),
+            reinterpret_cast<AnyFFT::Complex*>( m_tmp_spectral[mfi].dataPtr()),
+            AnyFFT::direction::C2R, AMREX_SPACEDIM);
+    }
+}
+
+SpectralPoissonSolver::~SpectralPoissonSolver ()
+{
+    for ( MFIter mfi(m_tmp_real); mfi.isValid(); ++mfi ){
+        AnyFFT::DestroyPlan(m_forward_plan[mfi]);
+        AnyFFT::DestroyPlan(m_backward_plan[mfi]);
+    }
+}
+
+/* \brief Fill `m_green_spectral` with the FFT of the integrated Green's function
+ *
+ * The source is assumed to move along the grid axis on which `beta` has
+ * its largest component (the transverse components are neglected). Along this
+ * axis, the boosted Poisson operator is made isotropic by stretching the
+ * coordinate by gamma ; the integrated Green's function is then the integral of
+ * the free-space Green's function over the stretched cell.
+ *
+ * \param beta Velocity of the source, normalized by c
+ */
+void
+SpectralPoissonSolver::ComputeGreenFunction (std::array<Real, 3> const beta)
+{
+    WARPX_PROFILE("SpectralPoissonSolver::ComputeGreenFunction");
+
+#if (AMREX_SPACEDIM == 3)
+    const std::array<Real, AMREX_SPACEDIM> beta_dim = {{ beta[0], beta[1], beta[2] }};
+#else
+    const std::array<Real, AMREX_SPACEDIM> beta_dim = {{ beta[0], beta[2] }};
+#endif
+    int dir = 0;
+    for (int idim=1; idim<AMREX_SPACEDIM; idim++) {
+        if (std::abs(beta_dim[idim]) > std::abs(beta_dim[dir])) dir = idim;
+    }
+    const double gamma = 1./std::sqrt(1. - double(beta_dim[dir])*double(beta_dim[dir]));
+    std::array<double, AMREX_SPACEDIM> dx_s;
+    for (int idim=0; idim<AMREX_SPACEDIM; idim++) {
+        dx_s[idim] = m_geom.CellSize(idim);
+    }
+    dx_s[dir] *= gamma;
+
+    AMREX_D_TERM(const double dxs = dx_s[0];,
+                 const double dys = dx_s[1];,
+                 const double dzs = dx_s[2];)
+    AMREX_D_TERM(const int nx = m_fft_size[0];,
+                 const int ny = m_fft_size[1];,
+                 const int nz = m_fft_size[2];)
+    constexpr double inv_4pi = 1./(4.*MathConst::pi);
+
+    for ( MFIter mfi(m_tmp_real); mfi.isValid(); ++mfi ){
+        Array4<Real> const green_arr = m_tmp_real[mfi].array();
+        ParallelFor( m_tmp_real[mfi].box(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+            // Distance (in number of cells) corresponding to the FFT index,
+            // following the usual FFT convention for negative offsets
+            int const ii = (i <= nx/2) ? i : nx - i;
+            int const jj = (j <= ny/2) ? j : ny - j;
+            double xlo, xhi, wx, ylo, yhi, wy;
+            IGFCellBounds(ii, dxs, xlo, xhi, wx);
+#if (AMREX_SPACEDIM == 3)
+            IGFCellBounds(jj, dys, ylo, yhi, wy);
+            int const kk = (k <= nz/2) ? k : nz - k;
+            double zlo, zhi, wz;
+            IGFCellBounds(kk, dzs, zlo, zhi, wz);
+            double const G = wx*wy*wz*inv_4pi*(
+                  IGFPrimitive(xhi, yhi, zhi) - IGFPrimitive(xlo, yhi, zhi)
+                - IGFPrimitive(xhi, ylo, zhi) + IGFPrimitive(xlo, ylo, zhi)
+                - IGFPrimitive(xhi, yhi, zlo) + IGFPrimitive(xlo, yhi, zlo)
+                + IGFPrimitive(xhi, ylo, zlo) - IGFPrimitive(xlo, ylo, zlo) );
+#else
+            amrex::ignore_unused(k);
+            // In 2D, the second grid axis is z, and the Green's function
+            // is -ln(x^2+z^2)/(4 pi)
+            IGFCellBounds(jj, dys, ylo, yhi, wy);
+            double const G = -wx*wy*inv_4pi*(
+                  IGFPrimitive(xhi, yhi) - IGFPrimitive(xlo, yhi)
+                - IGFPrimitive(xhi, ylo) + IGFPrimitive(xlo, ylo) );
+#endif
+            green_arr(i,j,k) = static_cast<Real>(G);
+        });
+
+        AnyFFT::Execute(m_forward_plan[mfi]);
+
+        Array4<Complex> const green_spectral_arr = m_green_spectral[mfi].array();
+        Array4<const Complex> const tmp_arr = m_tmp_spectral[mfi].array();
+        ParallelFor( m_tmp_spectral[mfi].box(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+            green_spectral_arr(i,j,k) = tmp_arr(i,j,k);
+        });
+    }
+
+    m_green_beta = beta;
+    m_green_is_computed = true;
+}
+
+/* \brief Solve the Poisson equation with `rho` as a source
+ *
+ * \param rho  Charge density on the nodal grid of level 0
+ * \param phi  Potential on the nodal grid of level 0 (valid and guard cells are filled)
+ * \param beta Velocity of the source, normalized by c
+ */
+void
+SpectralPoissonSolver::Solve (const MultiFab& rho, MultiFab& phi,
+                              std::array<Real, 3> const beta)
+{
+    WARPX_PROFILE("SpectralPoissonSolver::Solve");
+
+    // Gather rho in a single box
+    m_rho_global.ParallelCopy(rho, 0, 0, 1);
+
+    if (!m_is_periodic && (!m_green_is_computed || beta != m_green_beta)) {
+        ComputeGreenFunction(beta);
+    }
+
+    const bool is_periodic = m_is_periodic;
+    AMREX_D_TERM(const int nx = m_fft_size[0];,
+                 const int ny = m_fft_size[1];,
+                 const int nz = m_fft_size[2];)
+#if (AMREX_SPACEDIM == 2)
+    constexpr int nz = 1;
+#endif
+    // Normalization of the FFT + IFFT, and physical constant
+    const Real inv_N_ep0 = 1._rt/(static_cast<Real>(m_tmp_real.boxArray().numPts())*PhysConst::ep0);
+    const Real beta_x = beta[0];
+    const Real beta_y = beta[1];
+    const Real beta_z = beta[2];
+
+    for ( MFIter mfi(m_tmp_real); mfi.isValid(); ++mfi ){
+
+        // Copy rho to the FFT buffer, padding with zeros outside of the domain
+        {
+            Array4<const Real> const rho_arr = m_rho_global[mfi].array();
+            Array4<Real> const tmp_arr = m_tmp_real[mfi].array();
+            const Box rho_bx = m_rho_global[mfi].box();
+            ParallelFor( m_tmp_real[mfi].box(),
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                tmp_arr(i,j,k) = rho_bx.contains(IntVect(AMREX_D_DECL(i,j,k))) ?
+                    rho_arr(i,j,k) : 0._rt;
+            });
+        }
+
+        AnyFFT::Execute(m_forward_plan[mfi]);
+
+        // Solve in spectral space
+        {
+            Array4<Complex> const tmp_arr = m_tmp_spectral[mfi].array();
+            const Box spectralspace_bx = m_tmp_spectral[mfi].box();
+            if (is_periodic) {
+                const Real* kx_arr = m_modified_k[0][mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+                const Real* ky_arr = m_modified_k[1][mfi].dataPtr();
+                const Real* kz_arr = m_modified_k[2][mfi].dataPtr();
+#else
+                const Real* kz_arr = m_modified_k[1][mfi].dataPtr();
+#endif
+                ParallelFor( spectralspace_bx,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                    const Real kx = kx_arr[i];
+#if (AMREX_SPACEDIM == 3)
+                    const Real ky = ky_arr[j];
+                    const Real kz = kz_arr[k];
+#else
+                    constexpr Real ky = 0._rt;
+                    const Real kz = kz_arr[j];
+#endif
+                    const Real beta_k = beta_x*kx + beta_y*ky + beta_z*kz;
+                    const Real k2 = kx*kx + ky*ky + kz*kz - beta_k*beta_k;
+                    if (k2 > 0._rt) {
+                        tmp_arr(i,j,k) *= inv_N_ep0/k2;
+                    } else {
+                        // The mean value of phi is set to 0
+                        tmp_arr(i,j,k) = 0._rt;
+                    }
+                });
+            } else {
+                Array4<const Complex> const green_arr = m_green_spectral[mfi].array();
+                ParallelFor( spectralspace_bx,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                    tmp_arr(i,j,k) *= inv_N_ep0*green_arr(i,j,k);
+                });
+            }
+        }
+
+        AnyFFT::Execute(m_backward_plan[mfi]);
+
+        // Copy to phi, including its guard cells: with periodic boundaries,
+        // they are the periodic images ; with open boundaries, they are
+        // part of the (zero-padded) solution.
+        {
+            Array4<Real> const phi_arr = m_phi_global[mfi].array();
+            Array4<const Real> const tmp_arr = m_tmp_real[mfi].array();
+            ParallelFor( m_phi_global[mfi].box(),
+                /* GCC 8.1-8.2 work-around (ICE):
+                 *   named capture in nonexcept lambda needed for modulo operands
+                 *   https://godbolt.org/z/ppbAzd
+                 */
+                [phi_arr, tmp_arr, nx, ny, nz]
+                AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                    phi_arr(i,j,k) = tmp_arr((i+nx)%nx, (j+ny)%ny, (k+nz)%nz);
+                });
+        }
+    }
+
+    // Scatter phi back to the distributed MultiFab
+    phi.ParallelCopy(m_phi_global, 0, 0, 1, m_phi_global.nGrowVect(), phi.nGrowVect());
+}
+
+#endif // WARPX_USE_PSATD
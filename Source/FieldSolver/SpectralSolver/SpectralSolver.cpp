@@ -33,6 +33,10 @@
  * \param dt       Time step
  * \param pml      Whether the boxes in which the solver is applied are PML boxes
  * \param periodic_single_box Whether the full simulation domain consists of a single periodic box (i.e. the global domain is not MPI parallelized)
+ * \param distributed_fft Whether a single FFT over the whole (periodic) domain is
+ *        performed in parallel, instead of local FFTs in each box with guard cells
+ * \param on_the_fly_coefficients Whether the coefficients of the standard PSATD algorithm
+ *        are recomputed at each time step instead of being stored
  */
 SpectralSolver::SpectralSolver(
                 const amrex::BoxArray& realspace_ba,
@@ -44,49 +48,59 @@ SpectralSolver::SpectralSolver(
                 const amrex::RealVect dx, const amrex::Real dt,
                 const bool pml, const bool periodic_single_box,
                 const bool update_with_rho,
-                const bool fft_do_time_averaging) {
+                const bool fft_do_time_averaging,
+                const bool on_the_fly_coefficients,
+                const bool distributed_fft) {
 
-    // Initialize all structures using the same distribution mapping dm
+    // Initialize all structures using the same distribution mapping fft_dm:
+    // for local FFTs, these are the boxes of `realspace_ba` ; for a
+    // distributed FFT, these are the slabs of the global FFT
+    amrex::BoxArray fft_ba = realspace_ba;
+    amrex::DistributionMapping fft_dm = dm;
+    if (distributed_fft) {
+        SpectralFieldData::DistributedFFTLayout(realspace_ba.minimalBox(), fft_ba, fft_dm);
+    }
 
     // - Initialize k space object (Contains info about the size of
-    // the spectral space corresponding to each box in `realspace_ba`,
+    // the spectral space corresponding to each box in `fft_ba`,
     // as well as the value of the corresponding k coordinates)
-    const SpectralKSpace k_space= SpectralKSpace(realspace_ba, dm, dx);
+    const SpectralKSpace k_space= SpectralKSpace(fft_ba, fft_dm, dx, distributed_fft);
 
     // - Select the algorithm depending on the input parameters
     //   Initialize the corresponding coefficients over k space
 
     if (pml) {
         algorithm = std::make_unique<PMLPsatdAlgorithm>(
-            k_space, dm, norder_x, norder_y, norder_z, nodal, dt);
+            k_space, fft_dm, norder_x, norder_y, norder_z, nodal, dt);
     }
     else {
         if (fft_do_time_averaging){
             algorithm = std::make_unique<AvgGalileanAlgorithm>(
-                k_space, dm, norder_x, norder_y, norder_z, nodal, v_galilean, dt);
+                k_space, fft_dm, norder_x, norder_y, norder_z, nodal, v_galilean, dt);
         }
         else {
             // Galilean PSATD algorithm
             if (v_galilean[0] != 0. || v_galilean[1] != 0. || v_galilean[2] != 0.) {
                 algorithm = std::make_unique<GalileanAlgorithm>(
-                    k_space, dm, norder_x, norder_y, norder_z, nodal, v_galilean, dt, update_with_rho);
+                    k_space, fft_dm, norder_x, norder_y, norder_z, nodal, v_galilean, dt, update_with_rho);
             }
             // Comoving PSATD algorithm
             else if (v_comoving[0] != 0. || v_comoving[1] != 0. || v_comoving[2] != 0.) {
                 algorithm = std::make_unique<ComovingPsatdAlgorithm>(
-                    k_space, dm, norder_x, norder_y, norder_z, nodal, v_comoving, dt, update_with_rho);
+                    k_space, fft_dm, norder_x, norder_y, norder_z, nodal, v_comoving, dt, update_with_rho);
             }
             // Standard PSATD algorithm
             else {
                 algorithm = std::make_unique<PsatdAlgorithm>(
-                    k_space, dm, norder_x, norder_y, norder_z, nodal, dt, update_with_rho);
+                    k_space, fft_dm, norder_x, norder_y, norder_z, nodal, dt, update_with_rho,
+                    on_the_fly_coefficients);
             }
         }
     }
 
     // - Initialize arrays for fields in spectral space + FFT plans
-    field_data = SpectralFieldData( realspace_ba, k_space, dm,
-            algorithm->getRequiredNumberOfFields(), periodic_single_box );
+    field_data = SpectralFieldData( fft_ba, k_space, fft_dm,
+            algorithm->getRequiredNumberOfFields(), periodic_single_box, distributed_fft );
 
 }
 
@@ -24,6 +24,8 @@
  * \param dt       Time step
  * \param pml      Whether the boxes in which the solver is applied are PML boxes
  *                 PML is not supported.
+ * \param distributed_hankel Whether the boxes may be decomposed along r,
+ *                 with Hankel transforms distributed among the boxes
  */
 SpectralSolverRZ::SpectralSolverRZ (amrex::BoxArray const & realspace_ba,
                                     amrex::DistributionMapping const & dm,
@@ -32,7 +34,8 @@ SpectralSolverRZ::SpectralSolverRZ (amrex::BoxArray const & realspace_ba,
                                     const amrex::Array<amrex::Real,3>& v_galilean,
                                     amrex::RealVect const dx, amrex::Real const dt,
                                     int const lev,
-                                    bool const update_with_rho)
+                                    bool const update_with_rho,
+                                    bool const distributed_hankel)
     : k_space(realspace_ba, dm, dx)
 {
     // Initialize all structures using the same distribution mapping dm
@@ -57,7 +60,7 @@ SpectralSolverRZ::SpectralSolverRZ (amrex::BoxArray const & realspace_ba,
     // - Initialize arrays for fields in spectral space + FFT plans
     field_data = SpectralFieldDataRZ(realspace_ba, k_space, dm,
                                      algorithm->getRequiredNumberOfFields(),
-                                     n_rz_azimuthal_modes, lev);
+                                     n_rz_azimuthal_modes, lev, distributed_hankel);
 }
 
 /* \brief Transform the component `i_comp` of MultiFab `field_mf`
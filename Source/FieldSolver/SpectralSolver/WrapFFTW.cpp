@@ -7,6 +7,11 @@
 
 #include "AnyFFT.H"
 
+#ifdef WARPX_USE_FFTW_MPI
+#   include <AMReX.H>
+#   include <AMReX_ParallelDescriptor.H>
+#endif
+
 namespace AnyFFT
 {
 #ifdef AMREX_USE_FLOAT
@@ -14,11 +19,25 @@ namespace AnyFFT
     const auto VendorCreatePlanC2R3D = fftwf_plan_dft_c2r_3d;
     const auto VendorCreatePlanR2C2D = fftwf_plan_dft_r2c_2d;
     const auto VendorCreatePlanC2R2D = fftwf_plan_dft_c2r_2d;
+#  ifdef WARPX_USE_FFTW_MPI
+    const auto VendorMPIInit = fftwf_mpi_init;
+    const auto VendorMPICleanup = fftwf_mpi_cleanup;
+    const auto VendorMPILocalSize = fftwf_mpi_local_size;
+    const auto VendorMPICreatePlanR2C = fftwf_mpi_plan_dft_r2c;
+    const auto VendorMPICreatePlanC2R = fftwf_mpi_plan_dft_c2r;
+#  endif
 #else
     const auto VendorCreatePlanR2C3D = fftw_plan_dft_r2c_3d;
     const auto VendorCreatePlanC2R3D = fftw_plan_dft_c2r_3d;
     const auto VendorCreatePlanR2C2D = fftw_plan_dft_r2c_2d;
     const auto VendorCreatePlanC2R2D = fftw_plan_dft_c2r_2d;
+#  ifdef WARPX_USE_FFTW_MPI
+    const auto VendorMPIInit = fftw_mpi_init;
+    const auto VendorMPICleanup = fftw_mpi_cleanup;
+    const auto VendorMPILocalSize = fftw_mpi_local_size;
+    const auto VendorMPICreatePlanR2C = fftw_mpi_plan_dft_r2c;
+    const auto VendorMPICreatePlanC2R = fftw_mpi_plan_dft_c2r;
+#  endif
 #endif
 
     FFTplan CreatePlan(const amrex::IntVect& real_size, amrex::Real * const real_array,
@@ -75,4 +94,71 @@ namespace AnyFFT
         fftw_execute( fft_plan.m_plan );
 #  endif
     }
+
+#ifdef WARPX_USE_FFTW_MPI
+    namespace {
+        /** Fill the global sizes in C order, as expected by FFTW */
+        void SwapSizes(const amrex::IntVect& real_size, const int dim, ptrdiff_t* n)
+        {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(dim == 2 || dim == 3,
+                "only dim=2 and dim=3 have been implemented");
+            // Swap dimensions: AMReX FAB are Fortran-order but FFTW is C-order
+            for (int i=0; i<dim; i++) n[i] = real_size[dim-1-i];
+        }
+
+        void InitDistributed()
+        {
+            static bool initialized = false;
+            if (!initialized) {
+                VendorMPIInit();
+                amrex::ExecOnFinalize(VendorMPICleanup);
+                initialized = true;
+            }
+        }
+    }
+
+    std::ptrdiff_t DistributedLocalSize(const amrex::IntVect& real_size, int& local_n,
+                                        int& local_start, const int dim)
+    {
+        InitDistributed();
+
+        // For real-to-complex FFTs, the local size is given by the complex array
+        ptrdiff_t n[3];
+        SwapSizes(real_size, dim, n);
+        n[dim-1] = n[dim-1]/2 + 1;
+
+        ptrdiff_t local_n0, local_0_start;
+        const ptrdiff_t alloc_local = VendorMPILocalSize(dim, n,
+            amrex::ParallelDescriptor::Communicator(), &local_n0, &local_0_start);
+        local_n = static_cast<int>(local_n0);
+        local_start = static_cast<int>(local_0_start);
+        return alloc_local;
+    }
+
+    FFTplan CreateDistributedPlan(const amrex::IntVect& real_size, amrex::Real * const real_array,
+                                  Complex * const complex_array, const direction dir, const int dim)
+    {
+        InitDistributed();
+
+        ptrdiff_t n[3];
+        SwapSizes(real_size, dim, n);
+
+        FFTplan fft_plan;
+        if (dir == direction::R2C){
+            fft_plan.m_plan = VendorMPICreatePlanR2C(dim, n, real_array, complex_array,
+                amrex::ParallelDescriptor::Communicator(), FFTW_ESTIMATE);
+        } else {
+            fft_plan.m_plan = VendorMPICreatePlanC2R(dim, n, complex_array, real_array,
+                amrex::ParallelDescriptor::Communicator(), FFTW_ESTIMATE);
+        }
+
+        // Store meta-data in fft_plan
+        fft_plan.m_real_array = real_array;
+        fft_plan.m_complex_array = complex_array;
+        fft_plan.m_dir = dir;
+        fft_plan.m_dim = dim;
+
+        return fft_plan;
+    }
+#endif
 }
@@ -30,6 +30,11 @@ void InjectorDensity::clear ()
         object.predefined.clear();
         break;
     }
+    case Type::from_file:
+    {
+        object.from_file.m_table.clear();
+        break;
+    }
     default:
         return;
     }
@@ -35,5 +35,12 @@ void InjectorMomentum::clear ()
         object.custom.clear();
         break;
     }
+    case Type::from_file:
+    {
+        object.from_file.m_ux_table.clear();
+        object.from_file.m_uy_table.clear();
+        object.from_file.m_uz_table.clear();
+        break;
+    }
     }
 }
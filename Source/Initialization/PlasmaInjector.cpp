@@ -375,6 +375,14 @@ void PlasmaInjector::parseDensity (ParmParse& pp)
         // Construct InjectorDensity with InjectorDensityParser.
         h_inj_rho.reset(new InjectorDensity((InjectorDensityParser*)nullptr,
                                             makeParser(str_density_function,{"x","y","z"})));
+    } else if (rho_prof_s == "read_from_file") {
+        std::string density_file;
+        std::string density_record = "density";
+        pp.get("density_file", density_file);
+        pp.query("density_record", density_record);
+        // Construct InjectorDensity with InjectorDensityFromFile.
+        h_inj_rho.reset(new InjectorDensity((InjectorDensityFromFile*)nullptr,
+                                            density_file, density_record));
     } else {
         //No need for profile definition if external file is used
         std::string s_inj_style;
@@ -505,6 +513,14 @@ void PlasmaInjector::parseMomentum (ParmParse& pp)
                                              makeParser(str_momentum_function_ux,{"x","y","z"}),
                                              makeParser(str_momentum_function_uy,{"x","y","z"}),
                                              makeParser(str_momentum_function_uz,{"x","y","z"})));
+    } else if (mom_dist_s == "read_from_file") {
+        std::string momentum_file;
+        std::string momentum_record = "u";
+        pp.get("momentum_file", momentum_file);
+        pp.query("momentum_record", momentum_record);
+        // Construct InjectorMomentum with InjectorMomentumFromFile.
+        h_inj_mom.reset(new InjectorMomentum((InjectorMomentumFromFile*)nullptr,
+                                             momentum_file, momentum_record));
     } else {
         //No need for momentum definition if external file is used
         std::string s_inj_style;
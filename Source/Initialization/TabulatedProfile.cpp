@@ -0,0 +1,137 @@
+/* Copyright 2021
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "TabulatedProfile.H"
+
+#include <AMReX.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Vector.H>
+
+#ifdef WARPX_USE_OPENPMD
+#   include <openPMD/openPMD.hpp>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using namespace amrex;
+
+TabulatedProfile::TabulatedProfile (std::string const& file_name, std::string const& mesh_name,
+                                    std::string const& component_name)
+{
+#ifdef WARPX_USE_OPENPMD
+    // Geometry of the table along x, y and z, and its values in SI units
+    Vector<Real> lo(3, 0._rt);
+    Vector<Real> dx(3, 1._rt);
+    Vector<int> n(3, 1);
+    Vector<Real> values;
+
+    if (ParallelDescriptor::IOProcessor()) {
+        openPMD::Series series(file_name, openPMD::Access::READ_ONLY);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(series.iterations.size() >= 1u,
+            file_name + " does not contain any iteration");
+        openPMD::Iteration it = series.iterations.begin()->second;
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(it.meshes.contains(mesh_name),
+            file_name + " does not contain the mesh record '" + mesh_name + "'");
+        openPMD::Mesh mesh = it.meshes[mesh_name];
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(mesh.dataOrder() == openPMD::Mesh::DataOrder::C,
+            "TabulatedProfile: only the C data order is supported");
+        openPMD::MeshRecordComponent comp = component_name.empty()
+            ? mesh[openPMD::MeshRecordComponent::SCALAR] : mesh[component_name];
+
+        // Attributes of the dimensions of the dataset (the last one varies fastest)
+        std::vector<std::string> const labels = mesh.axisLabels();
+        std::vector<double> const spacing = mesh.gridSpacing<double>();
+        std::vector<double> const offset = mesh.gridGlobalOffset();
+        std::vector<double> const position = comp.position<double>();
+        openPMD::Extent const extent = comp.getExtent();
+        double const grid_unit = mesh.gridUnitSI();
+
+        // Axis (x, y or z) of each dimension of the dataset
+        int const ndims = static_cast<int>(extent.size());
+        std::vector<int> axis(ndims);
+        for (int i = 0; i < ndims; ++i) {
+            if      (labels[i] == "x") axis[i] = 0;
+            else if (labels[i] == "y") axis[i] = 1;
+            else if (labels[i] == "z") axis[i] = 2;
+            else amrex::Abort("TabulatedProfile: unsupported axis '" + labels[i]
+                              + "' in " + file_name + " (must be x, y or z)");
+            n[axis[i]] = static_cast<int>(extent[i]);
+            lo[axis[i]] = static_cast<Real>((offset[i] + position[i]*spacing[i])*grid_unit);
+            dx[axis[i]] = static_cast<Real>(spacing[i]*grid_unit);
+        }
+
+        std::size_t npts = 1;
+        for (auto e : extent) npts *= e;
+        std::vector<double> raw(npts);
+        if (comp.getDatatype() == openPMD::Datatype::FLOAT) {
+            auto chunk = comp.loadChunk<float>();
+            series.flush();
+            std::copy(chunk.get(), chunk.get()+npts, raw.begin());
+        } else {
+            auto chunk = comp.loadChunk<double>();
+            series.flush();
+            std::copy(chunk.get(), chunk.get()+npts, raw.begin());
+        }
+
+        // Reorder the values so that x varies fastest
+        double const unit = comp.unitSI();
+        values.resize(npts);
+        for (std::size_t l = 0; l < npts; ++l) {
+            std::size_t rem = l;
+            int idx[3] = {0, 0, 0};
+            for (int i = ndims-1; i >= 0; --i) {
+                idx[axis[i]] = static_cast<int>(rem % extent[i]);
+                rem /= extent[i];
+            }
+            values[idx[0] + n[0]*(idx[1] + n[1]*idx[2])] = static_cast<Real>(raw[l]*unit);
+        }
+    }
+
+    // Broadcast the table to the other processors
+    int const root = ParallelDescriptor::IOProcessorNumber();
+    ParallelDescriptor::Bcast(n.data(), 3, root);
+    ParallelDescriptor::Bcast(lo.data(), 3, root);
+    ParallelDescriptor::Bcast(dx.data(), 3, root);
+    std::size_t const npts = static_cast<std::size_t>(n[0])*n[1]*n[2];
+    values.resize(npts);
+    ParallelDescriptor::Bcast(values.data(), npts, root);
+
+    for (int d = 0; d < 3; ++d) {
+        m_lo[d] = lo[d];
+        m_inv_dx[d] = 1._rt/dx[d];
+        m_n[d] = n[d];
+    }
+
+    m_host_data = ::new Real[npts];
+    std::copy(values.begin(), values.end(), m_host_data);
+#ifdef AMREX_USE_GPU
+    m_device_data = static_cast<Real*>(The_Arena()->alloc(npts*sizeof(Real)));
+    Gpu::htod_memcpy(m_device_data, m_host_data, npts*sizeof(Real));
+#else
+    m_device_data = m_host_data;
+#endif
+
+#else
+    amrex::ignore_unused(file_name, mesh_name, component_name);
+    amrex::Abort("Reading a tabulated profile requires openPMD support: "
+                 "Add USE_OPENPMD=TRUE when compiling WarpX.\n");
+#endif // WARPX_USE_OPENPMD
+}
+
+// Note that we are not allowed to have non-trivial destructor.
+// So we rely on clear() to free memory.
+void
+TabulatedProfile::clear ()
+{
+#ifdef AMREX_USE_GPU
+    The_Arena()->free(m_device_data);
+#endif
+    ::delete[] m_host_data;
+    m_host_data = nullptr;
+    m_device_data = nullptr;
+}
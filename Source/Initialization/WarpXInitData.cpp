@@ -14,6 +14,7 @@
 #include "Parser/GpuParser.H"
 #include "Utils/WarpXUtil.H"
 #include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXPlugin.H"
 
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
@@ -80,6 +81,7 @@ WarpX::InitData ()
             ComputeDt();
         }
         PostRestart();
+        WarpXPlugins::CallHook(&WarpXPlugin::AfterRestart, *this);
     }
 
     ComputePMLFactors();
@@ -118,6 +120,9 @@ WarpX::InitData ()
     }
 
     PerformanceHints();
+
+    WarpXPlugins::CallHook(&WarpXPlugin::AfterInit, *this);
+    WarpXPlugins::CallHook(&WarpXPlugin::ParticleLoader, *this);
 }
 
 void
@@ -0,0 +1,120 @@
+/* Copyright 2021
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "SharedMemoryArena.H"
+#include "WarpXCommUtil.H"
+
+#include <AMReX.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <cstdlib>
+#include <string>
+
+using namespace amrex;
+
+SharedMemoryArena::SharedMemoryArena (std::size_t capacity)
+    : m_capacity(capacity)
+{
+#ifdef AMREX_USE_MPI
+    const MPI_Comm node_comm = WarpXCommUtil::NodeCommunicator();
+    int node_size;
+    MPI_Comm_size(node_comm, &node_size);
+
+    char* base = nullptr;
+    MPI_Win_allocate_shared(static_cast<MPI_Aint>(m_capacity), 1, MPI_INFO_NULL,
+                            node_comm, &base, &m_win);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, m_win);
+
+    m_node_base.resize(node_size);
+    for (int r = 0; r < node_size; ++r) {
+        MPI_Aint bytes;
+        int disp_unit;
+        MPI_Win_shared_query(m_win, r, &bytes, &disp_unit, &m_node_base[r]);
+    }
+#else
+    m_buffer = std::malloc(m_capacity);
+    m_node_base.push_back(static_cast<char*>(m_buffer));
+#endif
+}
+
+SharedMemoryArena::~SharedMemoryArena ()
+{
+#ifdef AMREX_USE_MPI
+    MPI_Win_unlock_all(m_win);
+    MPI_Win_free(&m_win);
+#else
+    std::free(m_buffer);
+#endif
+}
+
+void*
+SharedMemoryArena::alloc (std::size_t nbytes)
+{
+    const std::size_t aligned_bytes = Arena::align(nbytes);
+    if (m_used + aligned_bytes > m_capacity) {
+        amrex::Abort("SharedMemoryArena::alloc: out of memory (requested "
+                     + std::to_string(nbytes) + " bytes, "
+                     + std::to_string(m_capacity - m_used) + " available)");
+    }
+#ifdef AMREX_USE_MPI
+    int node_rank;
+    MPI_Comm_rank(WarpXCommUtil::NodeCommunicator(), &node_rank);
+    char* ptr = m_node_base[node_rank] + m_used;
+#else
+    char* ptr = m_node_base[0] + m_used;
+#endif
+    m_used += aligned_bytes;
+    return ptr;
+}
+
+void
+SharedMemoryArena::Sync ()
+{
+#ifdef AMREX_USE_MPI
+    MPI_Win_sync(m_win);
+#endif
+}
+
+std::size_t
+SharedMemoryArena::BytesNeeded (const BoxArray& ba, const DistributionMapping& dm,
+                                const int ncomp, const IntVect& ngrow)
+{
+    std::size_t nbytes = 0;
+    const int myproc = ParallelDescriptor::MyProc();
+    for (int i = 0; i < ba.size(); ++i) {
+        if (dm[i] != myproc) continue;
+        const Box bx = amrex::grow(ba[i], ngrow);
+        nbytes += Arena::align(bx.numPts()*ncomp*sizeof(Real));
+    }
+    return nbytes;
+}
+
+const std::vector<Long>&
+SharedMemoryArena::FabOffsets (const MultiFab& mf)
+{
+    auto it = m_fab_offsets.find(&mf);
+    if (it != m_fab_offsets.end()) return it->second;
+
+    std::vector<Long> offsets(mf.size(), -1);
+#ifdef AMREX_USE_MPI
+    const MPI_Comm node_comm = WarpXCommUtil::NodeCommunicator();
+    int node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const char* ptr = reinterpret_cast<const char*>(mf[mfi].dataPtr());
+        offsets[mfi.index()] = ptr - m_node_base[node_rank];
+    }
+    // Each box is owned by one rank only: the maximum gathers the offsets of the node
+    MPI_Allreduce(MPI_IN_PLACE, offsets.data(), static_cast<int>(offsets.size()),
+                  ParallelDescriptor::Mpi_typemap<Long>::type(), MPI_MAX, node_comm);
+#else
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const char* ptr = reinterpret_cast<const char*>(mf[mfi].dataPtr());
+        offsets[mfi.index()] = ptr - m_node_base[0];
+    }
+#endif
+    return m_fab_offsets.emplace(&mf, std::move(offsets)).first->second;
+}
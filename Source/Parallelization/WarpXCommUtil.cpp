@@ -0,0 +1,787 @@
+/* Copyright 2021
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "WarpXCommUtil.H"
+#include "SharedMemoryArena.H"
+#include "WarpX.H"
+#include "Utils/WarpXProfilerWrapper.H"
+
+#include <AMReX.H>
+#include <AMReX_IArrayBox.H>
+#include <AMReX_Loop.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+using namespace amrex;
+
+namespace
+{
+    using WarpXCommUtil::comm_float_type;
+    using CommFab = FabArray<BaseFab<comm_float_type> >;
+
+    /** Whether the data needs to be converted for the single-precision communications */
+    bool UseReducedPrecision (bool flag)
+    {
+        return flag && !std::is_same<Real, comm_float_type>::value;
+    }
+
+    /** Copy `ncomp` components of `src` (starting at `scomp`) to `dst`, including `nghost` guard cells */
+    void CopyToCommFab (CommFab& dst, const MultiFab& src, const int scomp, const int ncomp,
+                        const IntVect& nghost)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(dst, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.growntilebox(nghost);
+            Array4<comm_float_type> const& d = dst.array(mfi);
+            Array4<Real const> const& s = src.const_array(mfi);
+            amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept {
+                d(i,j,k,n) = static_cast<comm_float_type>(s(i,j,k,scomp+n));
+            });
+        }
+    }
+
+    /** Set to 1 the cells of `mask` that overlap the boxes of `src_ba` grown by
+     *  `src_nghost` (or one of their periodic images), i.e. the cells that receive
+     *  data in a FillBoundary or a ParallelCopy from `src_ba`, and all the other
+     *  cells to 0. The mask is computed from the BoxArray, without communication. */
+    void SetReceivedMask (IArrayBox& mask, const BoxArray& src_ba, const IntVect& src_nghost,
+                          const Periodicity& period)
+    {
+        mask.setVal<RunOn::Device>(0);
+        std::vector<std::pair<int,Box> > isects;
+        for (const auto& sh : period.shiftIntVect()) {
+            src_ba.intersections(mask.box() + sh, isects, false, src_nghost);
+            for (const auto& is : isects) {
+                mask.setVal<RunOn::Device>(1, is.second - sh, 0, 1);
+            }
+        }
+    }
+
+#ifdef AMREX_USE_MPI
+    /** MPI ranks that share the same node, and shared-memory window in
+     *  which each of them writes the data that it sends to the others */
+    struct NodeComm
+    {
+        bool initialized = false;
+        MPI_Comm comm = MPI_COMM_NULL;
+        int rank = 0;
+        int size = 1;
+        std::vector<int> node_rank_of; //!< node rank of each global rank (-1 if on another node)
+        MPI_Win win = MPI_WIN_NULL;
+        Long capacity = 0; //!< number of Reals that fit in the window of each rank
+        std::vector<char*> peer_base; //!< start of the window of each node rank
+    };
+
+    NodeComm node_comm;
+
+    void InitNodeComm ()
+    {
+        if (node_comm.initialized) return;
+        const MPI_Comm comm = ParallelDescriptor::Communicator();
+        const int myproc = ParallelDescriptor::MyProc();
+        MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, myproc, MPI_INFO_NULL, &node_comm.comm);
+        MPI_Comm_rank(node_comm.comm, &node_comm.rank);
+        MPI_Comm_size(node_comm.comm, &node_comm.size);
+
+        std::vector<int> global_ranks(node_comm.size);
+        MPI_Allgather(&myproc, 1, MPI_INT, global_ranks.data(), 1, MPI_INT, node_comm.comm);
+        node_comm.node_rank_of.assign(ParallelDescriptor::NProcs(), -1);
+        for (int r = 0; r < node_comm.size; ++r) {
+            node_comm.node_rank_of[global_ranks[r]] = r;
+        }
+        node_comm.initialized = true;
+        amrex::ExecOnFinalize(WarpXCommUtil::Finalize);
+    }
+
+#endif
+
+#if defined(AMREX_USE_MPI) && !defined(AMREX_USE_GPU)
+    /** Region `dst_box` of the box `dst_gid` that receives the values of the
+     *  box `src_gid` at the location `dst_box + shift` (periodic images) */
+    struct CommTag
+    {
+        int src_gid;
+        int dst_gid;
+        Box dst_box;
+        IntVect shift;
+        Long offset; //!< offset of the data in the communication buffer, in number of points
+    };
+
+    /** Communication pattern of the sum over overlapping regions (or of the filling
+     *  of the guard cells), for a given BoxArray, DistributionMapping, number of guard
+     *  cells and periodicity */
+    struct CommPlan
+    {
+        // Copies of the BoxArray and DistributionMapping of the plan: the BDKey alone
+        // does not identify them, since a new BoxArray (e.g. after a regrid or a load
+        // balance) can be allocated at the address of a deleted one
+        BoxArray ba;
+        DistributionMapping dm;
+        IntVect src_nghost;
+        IntVect dst_nghost;
+        Periodicity period;
+        bool is_fill; //!< guard cell filling (true) or summation of the overlaps (false)
+        // Contributions between boxes owned by this rank
+        std::vector<CommTag> local_tags;
+        // Contributions sent to / received from other ranks, for each rank
+        std::map<int, std::vector<CommTag> > send_tags;
+        std::map<int, std::vector<CommTag> > recv_tags;
+        std::map<int, Long> send_npts;
+        std::map<int, Long> recv_npts;
+    };
+
+    using CommPlanCache = std::map<FabArrayBase::BDKey, std::vector<std::unique_ptr<CommPlan> > >;
+    // Patterns of both the shared-memory FillBoundary and SumBoundary
+    CommPlanCache plan_cache;
+    // Maximum number of BoxArray/DistributionMapping pairs kept in the cache
+    constexpr int plan_cache_max_size = 64;
+
+    /** Size of the header of each window, which stores the offset of
+     *  the data sent to each node rank */
+    Long WindowHeaderBytes ()
+    {
+        return node_comm.size * static_cast<Long>(sizeof(Long));
+    }
+
+    /** Make sure that the window of each rank holds at least `n_reals` values
+     *  (collective over the node communicator) */
+    void ReserveWindow (Long n_reals)
+    {
+        Long n_reals_max = n_reals;
+        MPI_Allreduce(&n_reals, &n_reals_max, 1, ParallelDescriptor::Mpi_typemap<Long>::type(),
+                      MPI_MAX, node_comm.comm);
+        if (node_comm.win != MPI_WIN_NULL && n_reals_max <= node_comm.capacity) return;
+
+        if (node_comm.win != MPI_WIN_NULL) {
+            MPI_Win_unlock_all(node_comm.win);
+            MPI_Win_free(&node_comm.win);
+        }
+        // Grow geometrically, to avoid frequent reallocations
+        node_comm.capacity = std::max(n_reals_max, 2*node_comm.capacity);
+        const MPI_Aint bytes = WindowHeaderBytes() + node_comm.capacity*sizeof(Real);
+        char* base = nullptr;
+        MPI_Win_allocate_shared(bytes, 1, MPI_INFO_NULL, node_comm.comm, &base, &node_comm.win);
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, node_comm.win);
+
+        node_comm.peer_base.resize(node_comm.size);
+        for (int r = 0; r < node_comm.size; ++r) {
+            MPI_Aint peer_bytes;
+            int disp_unit;
+            MPI_Win_shared_query(node_comm.win, r, &peer_bytes, &disp_unit, &node_comm.peer_base[r]);
+        }
+    }
+
+    Long* WindowHeader (int node_rank)
+    {
+        return reinterpret_cast<Long*>(node_comm.peer_base[node_rank]);
+    }
+
+    Real* WindowData (int node_rank)
+    {
+        return reinterpret_cast<Real*>(node_comm.peer_base[node_rank] + WindowHeaderBytes());
+    }
+
+    bool IsOnNode (int proc)
+    {
+        return node_comm.node_rank_of[proc] >= 0;
+    }
+    /** Sort the tags exchanged with one rank in the same order on
+     *  both sides, and compute their offset in the buffer */
+    Long SortAndSetOffsets (std::vector<CommTag>& tags)
+    {
+        std::sort(tags.begin(), tags.end(),
+            [] (const CommTag& a, const CommTag& b) {
+                if (a.dst_gid != b.dst_gid) return a.dst_gid < b.dst_gid;
+                if (a.src_gid != b.src_gid) return a.src_gid < b.src_gid;
+                if (a.shift != b.shift) return a.shift.lexLT(b.shift);
+                return a.dst_box.smallEnd().lexLT(b.dst_box.smallEnd());
+            });
+        Long npts = 0;
+        for (auto& tag : tags) {
+            tag.offset = npts;
+            npts += tag.dst_box.numPts();
+        }
+        return npts;
+    }
+
+    std::unique_ptr<CommPlan>
+    BuildSumPlan (const BoxArray& ba, const DistributionMapping& dm,
+                  const IntVect& src_nghost, const IntVect& dst_nghost,
+                  const Periodicity& period)
+    {
+        auto plan = std::make_unique<CommPlan>();
+        plan->ba = ba;
+        plan->dm = dm;
+        plan->src_nghost = src_nghost;
+        plan->dst_nghost = dst_nghost;
+        plan->period = period;
+        plan->is_fill = false;
+
+        const int myproc = ParallelDescriptor::MyProc();
+        const Vector<int>& pmap = dm.ProcessorMap();
+        const std::vector<IntVect> shifts = period.shiftIntVect();
+        std::vector<std::pair<int,Box> > isects;
+
+        // Data received by the boxes owned by this rank
+        for (int i = 0; i < ba.size(); ++i) {
+            if (pmap[i] != myproc) continue;
+            const Box dst_bx = amrex::grow(ba[i], dst_nghost);
+            for (const auto& sh : shifts) {
+                ba.intersections(dst_bx + sh, isects, false, src_nghost);
+                for (const auto& is : isects) {
+                    const int j = is.first;
+                    const CommTag tag{j, i, is.second - sh, sh, 0};
+                    if (pmap[j] == myproc) {
+                        plan->local_tags.push_back(tag);
+                    } else {
+                        plan->recv_tags[pmap[j]].push_back(tag);
+                    }
+                }
+            }
+        }
+
+        // Data sent by the boxes owned by this rank
+        for (int j = 0; j < ba.size(); ++j) {
+            if (pmap[j] != myproc) continue;
+            const Box src_bx = amrex::grow(ba[j], src_nghost);
+            for (const auto& sh : shifts) {
+                ba.intersections(src_bx - sh, isects, false, dst_nghost);
+                for (const auto& is : isects) {
+                    const int i = is.first;
+                    if (pmap[i] != myproc) {
+                        plan->send_tags[pmap[i]].push_back(CommTag{j, i, is.second, sh, 0});
+                    }
+                }
+            }
+        }
+
+        for (auto& kv : plan->send_tags) plan->send_npts[kv.first] = SortAndSetOffsets(kv.second);
+        for (auto& kv : plan->recv_tags) plan->recv_npts[kv.first] = SortAndSetOffsets(kv.second);
+        return plan;
+    }
+
+    std::unique_ptr<CommPlan>
+    BuildFillPlan (const BoxArray& ba, const DistributionMapping& dm,
+                   const IntVect& nghost, const Periodicity& period)
+    {
+        auto plan = std::make_unique<CommPlan>();
+        plan->ba = ba;
+        plan->dm = dm;
+        plan->src_nghost = IntVect::TheZeroVector();
+        plan->dst_nghost = nghost;
+        plan->period = period;
+        plan->is_fill = true;
+
+        const int myproc = ParallelDescriptor::MyProc();
+        const Vector<int>& pmap = dm.ProcessorMap();
+        const std::vector<IntVect> shifts = period.shiftIntVect();
+        std::vector<std::pair<int,Box> > isects;
+
+        // Guard cells of box `i` covered by the valid region of box `j` (shifted by `sh`)
+        auto add_tags = [&] (int i, int j, const Box& isect, const IntVect& sh,
+                             std::vector<CommTag>& tags) {
+            if (i == j && sh == IntVect::TheZeroVector()) return;
+            for (const Box& b : amrex::boxDiff(isect, ba[i])) {
+                tags.push_back(CommTag{j, i, b, sh, 0});
+            }
+        };
+
+        // Data received by the boxes owned by this rank
+        for (int i = 0; i < ba.size(); ++i) {
+            if (pmap[i] != myproc) continue;
+            const Box dst_bx = amrex::grow(ba[i], nghost);
+            for (const auto& sh : shifts) {
+                ba.intersections(dst_bx + sh, isects);
+                for (const auto& is : isects) {
+                    const int j = is.first;
+                    auto& tags = (pmap[j] == myproc) ? plan->local_tags : plan->recv_tags[pmap[j]];
+                    add_tags(i, j, is.second - sh, sh, tags);
+                }
+            }
+        }
+
+        // Data sent by the boxes owned by this rank
+        for (int j = 0; j < ba.size(); ++j) {
+            if (pmap[j] != myproc) continue;
+            for (const auto& sh : shifts) {
+                ba.intersections(ba[j] - sh, isects, false, nghost);
+                for (const auto& is : isects) {
+                    const int i = is.first;
+                    if (pmap[i] != myproc) add_tags(i, j, is.second, sh, plan->send_tags[pmap[i]]);
+                }
+            }
+        }
+
+        for (auto& kv : plan->send_tags) plan->send_npts[kv.first] = SortAndSetOffsets(kv.second);
+        for (auto& kv : plan->recv_tags) plan->recv_npts[kv.first] = SortAndSetOffsets(kv.second);
+        return plan;
+    }
+
+    const CommPlan&
+    GetPlan (const MultiFab& mf, const IntVect& src_nghost,
+             const IntVect& dst_nghost, const Periodicity& period, bool is_fill)
+    {
+        auto& plans = plan_cache[mf.getBDKey()];
+        if (!plans.empty() &&
+            (plans.front()->ba != mf.boxArray() || plans.front()->dm != mf.DistributionMap())) {
+            // Stale patterns of a deleted BoxArray/DistributionMapping with the same key
+            plans.clear();
+        }
+        for (const auto& p : plans) {
+            if (p->is_fill == is_fill && p->src_nghost == src_nghost &&
+                p->dst_nghost == dst_nghost && p->period == period) {
+                return *p;
+            }
+        }
+        if (static_cast<int>(plan_cache.size()) > plan_cache_max_size) {
+            // Typically after many regrids: drop the patterns of the old BoxArrays
+            auto current = std::move(plans);
+            plan_cache.clear();
+            plan_cache[mf.getBDKey()] = std::move(current);
+        }
+        auto& new_plans = plan_cache[mf.getBDKey()];
+        if (is_fill) {
+            new_plans.push_back(BuildFillPlan(mf.boxArray(), mf.DistributionMap(), dst_nghost, period));
+        } else {
+            new_plans.push_back(BuildSumPlan(mf.boxArray(), mf.DistributionMap(),
+                                             src_nghost, dst_nghost, period));
+        }
+        return *new_plans.back();
+    }
+
+    /** Copy the regions described by `tags` from `src` to the buffer `buf` */
+    void PackTags (const MultiFab& src, const std::vector<CommTag>& tags,
+                   Real* buf, const int ncomp)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for
+#endif
+        for (int it = 0; it < static_cast<int>(tags.size()); ++it) {
+            const CommTag& tag = tags[it];
+            Array4<Real const> const src_arr = src[tag.src_gid].const_array();
+            const Dim3 lo = amrex::lbound(tag.dst_box);
+            const Dim3 hi = amrex::ubound(tag.dst_box);
+            Array4<Real> const buf_arr(buf + tag.offset*ncomp, lo,
+                                       Dim3{hi.x+1, hi.y+1, hi.z+1}, ncomp);
+            const Dim3 sh = tag.shift.dim3();
+            amrex::LoopConcurrentOnCpu(tag.dst_box, ncomp,
+            [&] (int i, int j, int k, int n) noexcept {
+                buf_arr(i,j,k,n) = src_arr(i+sh.x, j+sh.y, k+sh.z, n);
+            });
+        }
+    }
+
+    /** Add the regions described by `tags`, from the buffer `buf`, to `dst`
+     *  (serial over the tags, since several of them can update the same cells) */
+    void UnpackAddTags (MultiFab& dst, const std::vector<CommTag>& tags,
+                        Real const* buf, const int icomp, const int ncomp)
+    {
+        for (const auto& tag : tags) {
+            Array4<Real> const dst_arr = dst[tag.dst_gid].array();
+            const Dim3 lo = amrex::lbound(tag.dst_box);
+            const Dim3 hi = amrex::ubound(tag.dst_box);
+            Array4<Real const> const buf_arr(buf + tag.offset*ncomp, lo,
+                                             Dim3{hi.x+1, hi.y+1, hi.z+1}, ncomp);
+            amrex::LoopConcurrentOnCpu(tag.dst_box, ncomp,
+            [&] (int i, int j, int k, int n) noexcept {
+                dst_arr(i,j,k,icomp+n) += buf_arr(i,j,k,n);
+            });
+        }
+    }
+
+    /** Copy the region described by `tag` from `src` to `dst` */
+    void CopyTag (Array4<Real> const& dst, Array4<Real const> const& src,
+                  const CommTag& tag, const int ncomp)
+    {
+        const Dim3 sh = tag.shift.dim3();
+        amrex::LoopConcurrentOnCpu(tag.dst_box, ncomp,
+        [&] (int i, int j, int k, int n) noexcept {
+            dst(i,j,k,n) = src(i+sh.x, j+sh.y, k+sh.z, n);
+        });
+    }
+
+    /** Fill the guard cells of `mf`, whose data is allocated in the shared-memory arena
+     *  `arena`: the valid cells of the boxes owned by the same node are read in place,
+     *  and only the data of the other nodes is exchanged through MPI messages */
+    void NodeAwareFillBoundary (MultiFab& mf, const IntVect& nghost, const Periodicity& period,
+                                SharedMemoryArena& arena)
+    {
+        WARPX_PROFILE("WarpXCommUtil::NodeAwareFillBoundary()");
+
+        InitNodeComm();
+        const CommPlan& plan = GetPlan(mf, IntVect::TheZeroVector(), nghost, period, true);
+        const std::vector<Long>& fab_offsets = arena.FabOffsets(mf);
+        const int ncomp = mf.nComp();
+        const BoxArray& ba = mf.boxArray();
+        const IntVect ngrow = mf.nGrowVect();
+
+        const MPI_Comm comm = ParallelDescriptor::Communicator();
+        const MPI_Datatype mpi_real = ParallelDescriptor::Mpi_typemap<Real>::type();
+        const int mpi_tag = ParallelDescriptor::SeqNum();
+
+        // Inter-node: post receives, then pack and send
+        std::map<int, Vector<Real> > recv_bufs, send_bufs;
+        Vector<MPI_Request> recv_reqs, send_reqs;
+        for (const auto& kv : plan.recv_npts) {
+            if (IsOnNode(kv.first)) continue;
+            auto& buf = recv_bufs[kv.first];
+            buf.resize(kv.second*ncomp);
+            recv_reqs.push_back(MPI_REQUEST_NULL);
+            MPI_Irecv(buf.data(), static_cast<int>(buf.size()), mpi_real, kv.first, mpi_tag,
+                      comm, &recv_reqs.back());
+        }
+        for (const auto& kv : plan.send_tags) {
+            if (IsOnNode(kv.first)) continue;
+            auto& buf = send_bufs[kv.first];
+            buf.resize(plan.send_npts.at(kv.first)*ncomp);
+            PackTags(mf, kv.second, buf.data(), ncomp);
+            send_reqs.push_back(MPI_REQUEST_NULL);
+            MPI_Isend(buf.data(), static_cast<int>(buf.size()), mpi_real, kv.first, mpi_tag,
+                      comm, &send_reqs.back());
+        }
+
+        // Wait until the valid cells of all the ranks of the node are up to date
+        arena.Sync();
+        MPI_Barrier(node_comm.comm);
+        arena.Sync();
+
+        for (const auto& tag : plan.local_tags) {
+            CopyTag(mf[tag.dst_gid].array(), mf[tag.src_gid].const_array(), tag, ncomp);
+        }
+        for (const auto& kv : plan.recv_tags) {
+            if (!IsOnNode(kv.first)) continue;
+            char* const peer_base = arena.NodeBase(node_comm.node_rank_of[kv.first]);
+            for (const auto& tag : kv.second) {
+                const Box src_bx = amrex::grow(ba[tag.src_gid], ngrow);
+                const Dim3 hi = amrex::ubound(src_bx);
+                Array4<Real const> const src_arr(
+                    reinterpret_cast<Real const*>(peer_base + fab_offsets[tag.src_gid]),
+                    amrex::lbound(src_bx), Dim3{hi.x+1, hi.y+1, hi.z+1}, ncomp);
+                CopyTag(mf[tag.dst_gid].array(), src_arr, tag, ncomp);
+            }
+        }
+        // The valid cells of this rank can only be modified once all peers have read them
+        MPI_Barrier(node_comm.comm);
+
+        // Inter-node data
+        if (!recv_reqs.empty()) {
+            Vector<MPI_Status> stats(recv_reqs.size());
+            MPI_Waitall(static_cast<int>(recv_reqs.size()), recv_reqs.data(), stats.data());
+        }
+        for (const auto& kv : recv_bufs) {
+            for (const auto& tag : plan.recv_tags.at(kv.first)) {
+                const Dim3 lo = amrex::lbound(tag.dst_box);
+                const Dim3 hi = amrex::ubound(tag.dst_box);
+                Array4<Real const> const buf_arr(kv.second.data() + tag.offset*ncomp, lo,
+                                                 Dim3{hi.x+1, hi.y+1, hi.z+1}, ncomp);
+                CommTag unshifted = tag;
+                unshifted.shift = IntVect::TheZeroVector();
+                CopyTag(mf[tag.dst_gid].array(), buf_arr, unshifted, ncomp);
+            }
+        }
+        if (!send_reqs.empty()) {
+            Vector<MPI_Status> stats(send_reqs.size());
+            MPI_Waitall(static_cast<int>(send_reqs.size()), send_reqs.data(), stats.data());
+        }
+    }
+#endif
+}
+
+namespace WarpXCommUtil
+{
+
+void
+FillBoundary (MultiFab& mf, const IntVect& nghost, const Periodicity& period)
+{
+#if defined(AMREX_USE_MPI) && !defined(AMREX_USE_GPU)
+    auto* shared_arena = dynamic_cast<SharedMemoryArena*>(mf.arena());
+    if (shared_arena && ParallelDescriptor::NProcs() > 1) {
+        NodeAwareFillBoundary(mf, nghost, period, *shared_arena);
+        return;
+    }
+#endif
+    if (UseReducedPrecision(WarpX::do_single_precision_comms)) {
+        WARPX_PROFILE("WarpXCommUtil::FillBoundary()");
+        const int ncomp = mf.nComp();
+        CommFab mf_tmp(mf.boxArray(), mf.DistributionMap(), ncomp, nghost);
+        CopyToCommFab(mf_tmp, mf, 0, ncomp, IntVect::TheZeroVector());
+        mf_tmp.FillBoundary(nghost, period);
+        // Copy back the guard cells that were filled by the communication only:
+        // the other guard cells of mf_tmp (e.g. at the edges of a non-periodic
+        // domain) are not initialized, and those of mf must be left unchanged
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.growntilebox(nghost);
+            const Box& vbx = mfi.validbox();
+            Array4<Real> const& d = mf.array(mfi);
+            Array4<comm_float_type const> const& s = mf_tmp.const_array(mfi);
+            IArrayBox mask(bx, 1, The_Async_Arena());
+            SetReceivedMask(mask, mf.boxArray(), IntVect::TheZeroVector(), period);
+            Array4<int const> const& m = mask.const_array();
+            amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept {
+                if (m(i,j,k) && !vbx.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                    d(i,j,k,n) = static_cast<Real>(s(i,j,k,n));
+                }
+            });
+        }
+    } else {
+        mf.FillBoundary(nghost, period);
+    }
+}
+
+void
+FillBoundary (MultiFab& mf, const Periodicity& period)
+{
+    FillBoundary(mf, mf.nGrowVect(), period);
+}
+
+void
+FillBoundary (Vector<MultiFab*> const& mf, const Periodicity& period)
+{
+    if (UseReducedPrecision(WarpX::do_single_precision_comms) || WarpX::do_shared_memory_fields) {
+        for (auto* m : mf) FillBoundary(*m, period);
+    } else {
+        amrex::FillBoundary(mf, period);
+    }
+}
+
+void
+ParallelCopy (MultiFab& dst, const MultiFab& src,
+              const int src_comp, const int dst_comp, const int num_comp,
+              const IntVect& src_nghost, const IntVect& dst_nghost,
+              const Periodicity& period, FabArrayBase::CpOp op)
+{
+    if (!UseReducedPrecision(WarpX::do_single_precision_comms)) {
+        dst.ParallelCopy(src, src_comp, dst_comp, num_comp, src_nghost, dst_nghost, period, op);
+        return;
+    }
+
+    WARPX_PROFILE("WarpXCommUtil::ParallelCopy()");
+    CommFab src_tmp(src.boxArray(), src.DistributionMap(), num_comp, src_nghost);
+    CopyToCommFab(src_tmp, src, src_comp, num_comp, src_nghost);
+    CommFab dst_tmp(dst.boxArray(), dst.DistributionMap(), num_comp, dst_nghost);
+    dst_tmp.setVal(0);
+    dst_tmp.ParallelCopy(src_tmp, 0, 0, num_comp, src_nghost, dst_nghost, period, op);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dst, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.growntilebox(dst_nghost);
+        Array4<Real> const& d = dst.array(mfi);
+        Array4<comm_float_type const> const& t = dst_tmp.const_array(mfi);
+        if (op == FabArrayBase::ADD) {
+            amrex::ParallelFor(bx, num_comp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept {
+                d(i,j,k,dst_comp+n) += static_cast<Real>(t(i,j,k,n));
+            });
+        } else {
+            // Cells that do not receive any data keep their full precision
+            IArrayBox mask(bx, 1, The_Async_Arena());
+            SetReceivedMask(mask, src.boxArray(), src_nghost, period);
+            Array4<int const> const& m = mask.const_array();
+            amrex::ParallelFor(bx, num_comp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept {
+                if (m(i,j,k)) {
+                    d(i,j,k,dst_comp+n) = static_cast<Real>(t(i,j,k,n));
+                }
+            });
+        }
+    }
+}
+
+void
+ParallelAdd (MultiFab& dst, const MultiFab& src,
+             const int src_comp, const int dst_comp, const int num_comp,
+             const IntVect& src_nghost, const IntVect& dst_nghost,
+             const Periodicity& period)
+{
+    ParallelCopy(dst, src, src_comp, dst_comp, num_comp, src_nghost, dst_nghost,
+                 period, FabArrayBase::ADD);
+}
+
+void
+CopyByOverlap (MultiFab& dst, const MultiFab& src, const Periodicity& period)
+{
+    // The data is moved between different grids: always in full precision
+    dst.ParallelCopy(src, 0, 0, dst.nComp(), src.nGrowVect(), dst.nGrowVect());
+    dst.ParallelCopy(src, 0, 0, dst.nComp(), IntVect(0), dst.nGrowVect(), period);
+}
+
+void
+SumBoundary (MultiFab& mf, const int icomp, const int ncomp,
+             const IntVect& dst_nghost, const Periodicity& period)
+{
+    if (UseReducedPrecision(WarpX::do_single_precision_current_sum)) {
+        WARPX_PROFILE("WarpXCommUtil::SumBoundary()");
+        const IntVect nghost = mf.nGrowVect();
+        CommFab mf_tmp(mf.boxArray(), mf.DistributionMap(), ncomp, nghost);
+        CopyToCommFab(mf_tmp, mf, icomp, ncomp, nghost);
+        mf_tmp.SumBoundary(0, ncomp, dst_nghost, period);
+        // Add the contributions of the other boxes, i.e. the difference between
+        // the sum and the (rounded) contribution of the box itself
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.growntilebox(dst_nghost);
+            Array4<Real> const& d = mf.array(mfi);
+            Array4<comm_float_type const> const& t = mf_tmp.const_array(mfi);
+            amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept {
+                const comm_float_type own = static_cast<comm_float_type>(d(i,j,k,icomp+n));
+                d(i,j,k,icomp+n) += static_cast<Real>(t(i,j,k,n) - own);
+            });
+        }
+    } else if (WarpX::do_hierarchical_sum_boundary) {
+        NodeAwareSumBoundary(mf, icomp, ncomp, dst_nghost, period);
+    } else {
+        mf.SumBoundary(icomp, ncomp, dst_nghost, period);
+    }
+}
+
+void
+NodeAwareSumBoundary (MultiFab& mf, const int icomp, const int ncomp,
+                      const IntVect& dst_nghost, const Periodicity& period)
+{
+#if !defined(AMREX_USE_MPI) || defined(AMREX_USE_GPU)
+    mf.SumBoundary(icomp, ncomp, dst_nghost, period);
+#else
+    if (ParallelDescriptor::NProcs() == 1) {
+        mf.SumBoundary(icomp, ncomp, dst_nghost, period);
+        return;
+    }
+
+    WARPX_PROFILE("WarpXCommUtil::NodeAwareSumBoundary()");
+
+    InitNodeComm();
+    const CommPlan& plan = GetPlan(mf, mf.nGrowVect(), dst_nghost, period, false);
+
+    // Copy of the values before the summation (including the guard cells)
+    const IntVect src_nghost = mf.nGrowVect();
+    MultiFab tmp(mf.boxArray(), mf.DistributionMap(), ncomp, src_nghost);
+    MultiFab::Copy(tmp, mf, icomp, 0, ncomp, src_nghost);
+
+    const MPI_Comm comm = ParallelDescriptor::Communicator();
+    const MPI_Datatype mpi_real = ParallelDescriptor::Mpi_typemap<Real>::type();
+    const int mpi_tag = ParallelDescriptor::SeqNum();
+
+    // Inter-node: post receives, then pack and send
+    std::map<int, Vector<Real> > recv_bufs, send_bufs;
+    Vector<MPI_Request> recv_reqs, send_reqs;
+    for (const auto& kv : plan.recv_npts) {
+        if (IsOnNode(kv.first)) continue;
+        auto& buf = recv_bufs[kv.first];
+        buf.resize(kv.second*ncomp);
+        recv_reqs.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(buf.data(), static_cast<int>(buf.size()), mpi_real, kv.first, mpi_tag,
+                  comm, &recv_reqs.back());
+    }
+    for (const auto& kv : plan.send_tags) {
+        if (IsOnNode(kv.first)) continue;
+        auto& buf = send_bufs[kv.first];
+        buf.resize(plan.send_npts.at(kv.first)*ncomp);
+        PackTags(tmp, kv.second, buf.data(), ncomp);
+        send_reqs.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(buf.data(), static_cast<int>(buf.size()), mpi_real, kv.first, mpi_tag,
+                  comm, &send_reqs.back());
+    }
+
+    // On-node: pack into the shared-memory window of this rank
+    Long n_reals_on_node = 0;
+    for (const auto& kv : plan.send_npts) {
+        if (IsOnNode(kv.first)) n_reals_on_node += kv.second*ncomp;
+    }
+    ReserveWindow(n_reals_on_node);
+    {
+        Long* header = WindowHeader(node_comm.rank);
+        Real* data = WindowData(node_comm.rank);
+        Long offset = 0;
+        for (const auto& kv : plan.send_tags) {
+            if (!IsOnNode(kv.first)) continue;
+            header[node_comm.node_rank_of[kv.first]] = offset;
+            PackTags(tmp, kv.second, data + offset, ncomp);
+            offset += plan.send_npts.at(kv.first)*ncomp;
+        }
+    }
+    MPI_Win_sync(node_comm.win);
+    MPI_Barrier(node_comm.comm);
+    MPI_Win_sync(node_comm.win);
+
+    // Sum the contributions of the boxes owned by this rank and by the same node
+    mf.setVal(0._rt, icomp, ncomp, dst_nghost);
+    for (const auto& tag : plan.local_tags) {
+        Array4<Real> const dst_arr = mf[tag.dst_gid].array();
+        Array4<Real const> const src_arr = tmp[tag.src_gid].const_array();
+        const Dim3 sh = tag.shift.dim3();
+        amrex::LoopConcurrentOnCpu(tag.dst_box, ncomp,
+        [&] (int i, int j, int k, int n) noexcept {
+            dst_arr(i,j,k,icomp+n) += src_arr(i+sh.x, j+sh.y, k+sh.z, n);
+        });
+    }
+    for (const auto& kv : plan.recv_tags) {
+        if (!IsOnNode(kv.first)) continue;
+        const int peer = node_comm.node_rank_of[kv.first];
+        const Long offset = WindowHeader(peer)[node_comm.rank];
+        UnpackAddTags(mf, kv.second, WindowData(peer) + offset, icomp, ncomp);
+    }
+    // The window of this rank can only be overwritten once all peers have read it
+    MPI_Barrier(node_comm.comm);
+
+    // Inter-node contributions
+    if (!recv_reqs.empty()) {
+        Vector<MPI_Status> stats(recv_reqs.size());
+        MPI_Waitall(static_cast<int>(recv_reqs.size()), recv_reqs.data(), stats.data());
+    }
+    for (const auto& kv : recv_bufs) {
+        UnpackAddTags(mf, plan.recv_tags.at(kv.first), kv.second.data(), icomp, ncomp);
+    }
+    if (!send_reqs.empty()) {
+        Vector<MPI_Status> stats(send_reqs.size());
+        MPI_Waitall(static_cast<int>(send_reqs.size()), send_reqs.data(), stats.data());
+    }
+#endif
+}
+
+#ifdef AMREX_USE_MPI
+MPI_Comm
+NodeCommunicator ()
+{
+    InitNodeComm();
+    return node_comm.comm;
+}
+#endif
+
+void
+Finalize ()
+{
+#if defined(AMREX_USE_MPI) && !defined(AMREX_USE_GPU)
+    plan_cache.clear();
+#endif
+#ifdef AMREX_USE_MPI
+    if (node_comm.win != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(node_comm.win);
+        MPI_Win_free(&node_comm.win);
+    }
+    if (node_comm.comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&node_comm.comm);
+    }
+    node_comm = NodeComm();
+#endif
+}
+
+}
@@ -8,9 +8,11 @@
  */
 #include "WarpX.H"
 #include "Utils/WarpXAlgorithmSelection.H"
+#include "Parallelization/WarpXCommUtil.H"
 
 #include <AMReX_BLProfiler.H>
 
+#include <array>
 #include <memory>
 #include <cstddef>
 
@@ -103,8 +105,10 @@ WarpX::LoadBalance ()
 
 
 void
-WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const DistributionMapping& dm)
+WarpX::RemakeLevel (int lev, Real time, const BoxArray& ba, const DistributionMapping& dm)
 {
+    ++fields_version;
+
     if (ba == boxArray(lev))
     {
         if (ParallelDescriptor::NProcs() == 1) return;
@@ -117,20 +121,34 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
         m_field_factory[lev] = std::make_unique<FArrayBoxFactory>();
 #endif
 
+        // Node-shared memory of E and B, for the new distribution mapping
+        std::unique_ptr<SharedMemoryArena> new_field_arena;
+        if (do_shared_memory_fields) {
+            std::size_t nbytes = 0;
+            for (int idim=0; idim < 3; ++idim) {
+                for (const auto* mf : {Bfield_fp[lev][idim].get(), Efield_fp[lev][idim].get()}) {
+                    nbytes += SharedMemoryArena::BytesNeeded(mf->boxArray(), dm, mf->nComp(), mf->nGrowVect());
+                }
+            }
+            new_field_arena = std::make_unique<SharedMemoryArena>(nbytes);
+        }
+
         // Fine patch
         for (int idim=0; idim < 3; ++idim)
         {
             {
                 const IntVect& ng = Bfield_fp[lev][idim]->nGrowVect();
                 auto pmf = std::make_unique<MultiFab>(Bfield_fp[lev][idim]->boxArray(),
-                                                                  dm, Bfield_fp[lev][idim]->nComp(), ng);
+                                                                  dm, Bfield_fp[lev][idim]->nComp(), ng,
+                                                                  MFInfo().SetArena(new_field_arena.get()));
                 pmf->Redistribute(*Bfield_fp[lev][idim], 0, 0, Bfield_fp[lev][idim]->nComp(), ng);
                 Bfield_fp[lev][idim] = std::move(pmf);
             }
             {
                 const IntVect& ng = Efield_fp[lev][idim]->nGrowVect();
                 auto pmf = std::make_unique<MultiFab>(Efield_fp[lev][idim]->boxArray(),
-                                                                  dm, Efield_fp[lev][idim]->nComp(), ng);
+                                                                  dm, Efield_fp[lev][idim]->nComp(), ng,
+                                                                  MFInfo().SetArena(new_field_arena.get()));
                 pmf->Redistribute(*Efield_fp[lev][idim], 0, 0, Efield_fp[lev][idim]->nComp(), ng);
                 Efield_fp[lev][idim] = std::move(pmf);
             }
@@ -302,14 +320,141 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
 
         SetDistributionMap(lev, dm);
 
+        // The old fields (and their aliases) have been replaced: release their memory
+        m_field_arena[lev] = std::move(new_field_arena);
+
     } else
     {
-        amrex::Abort("RemakeLevel: to be implemented");
+        // Keep the E, B and F fields of the old grids (and the arena that contains them)
+        std::unique_ptr<SharedMemoryArena> old_arena = std::move(m_field_arena[lev]);
+        std::array<std::unique_ptr<MultiFab>,3> old_E_fp, old_B_fp, old_E_cp, old_B_cp;
+        for (int i = 0; i < 3; ++i) {
+            old_E_fp[i] = std::move(Efield_fp[lev][i]);
+            old_B_fp[i] = std::move(Bfield_fp[lev][i]);
+            old_E_cp[i] = std::move(Efield_cp[lev][i]);
+            old_B_cp[i] = std::move(Bfield_cp[lev][i]);
+        }
+        std::unique_ptr<MultiFab> old_F_fp = std::move(F_fp[lev]);
+        std::unique_ptr<MultiFab> old_F_cp = std::move(F_cp[lev]);
+        ClearLevel(lev);
+
+        SetBoxArray(lev, ba);
+        SetDistributionMap(lev, dm);
+        AllocLevelData(lev, ba, dm);
+        // The newly refined regions start from the initial fields (and F = 0)
+        InitLevelData(lev, time);
+
+        // Where the old and new grids overlap, keep the current fields
+        const Periodicity& period = Geom(lev).periodicity();
+        for (int i = 0; i < 3; ++i) {
+            WarpXCommUtil::CopyByOverlap(*Efield_fp[lev][i], *old_E_fp[i], period);
+            WarpXCommUtil::CopyByOverlap(*Bfield_fp[lev][i], *old_B_fp[i], period);
+        }
+        if (F_fp[lev] && old_F_fp) {
+            WarpXCommUtil::CopyByOverlap(*F_fp[lev], *old_F_fp, period);
+        }
+        if (lev > 0) {
+            const Periodicity& cperiod = Geom(lev-1).periodicity();
+            for (int i = 0; i < 3; ++i) {
+                WarpXCommUtil::CopyByOverlap(*Efield_cp[lev][i], *old_E_cp[i], cperiod);
+                WarpXCommUtil::CopyByOverlap(*Bfield_cp[lev][i], *old_B_cp[i], cperiod);
+            }
+            if (F_cp[lev] && old_F_cp) {
+                WarpXCommUtil::CopyByOverlap(*F_cp[lev], *old_F_cp, cperiod);
+            }
+        }
+
+        // Release the old fields before their arena
+        for (int i = 0; i < 3; ++i) {
+            old_E_fp[i].reset();
+            old_B_fp[i].reset();
+            old_E_cp[i].reset();
+            old_B_cp[i].reset();
+        }
+        old_arena.reset();
     }
     // Re-initialize diagnostic functors that stores pointers to the user-requested fields at level, lev.
     multi_diags->InitializeFieldFunctors( lev );
 }
 
+void
+WarpX::MakeNewLevelFromCoarse (int lev, Real time, const BoxArray& ba,
+                               const DistributionMapping& dm)
+{
+    AllocLevelData(lev, ba, dm);
+    // The new level starts from the initial fields (and F = 0), as at initialization
+    InitLevelData(lev, time);
+    multi_diags->InitializeFieldFunctors( lev );
+}
+
+void
+WarpX::DynamicRegrid (Real time)
+{
+    WARPX_PROFILE("WarpX::DynamicRegrid()");
+
+    const int old_finest_level = finest_level;
+    Vector<BoxArray> old_grids(max_level+1);
+    for (int lev = 1; lev <= finest_level; ++lev) {
+        old_grids[lev] = boxArray(lev);
+    }
+
+    // Tag the cells (ErrorEst) and remake the levels above level 0
+    regrid(0, time);
+
+    bool regridded = (finest_level != old_finest_level);
+    for (int lev = 1; lev <= finest_level; ++lev) {
+        regridded = regridded || (boxArray(lev) != old_grids[lev]);
+    }
+    if (!regridded) return;
+
+    if (do_pml) {
+        RemakePML();
+        ComputePMLFactors();
+    }
+    BuildBufferMasks();
+
+    // Move the particles to the tiles of the new grids
+    if (finest_level != old_finest_level) mypc->ResizeLevelData();
+    mypc->Redistribute();
+    mypc->defineAllParticleTiles();
+
+    if (verbose && ParallelDescriptor::IOProcessor()) {
+        std::cout << "\nGrids Summary after regrid:\n";
+        printGridSummary(std::cout, 0, finestLevel());
+    }
+}
+
+void
+WarpX::RemakePML ()
+{
+    // The PML boxes are built from the grids of all the levels
+    const int nlevs = finestLevel()+1;
+    Vector<std::unique_ptr<PML> > old_pml(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev) {
+        old_pml[lev] = std::move(pml[lev]);
+    }
+    for (int lev = nlevs; lev <= max_level; ++lev) {
+        pml[lev].reset();
+    }
+    InitPML();
+
+    for (int lev = 0; lev < nlevs; ++lev) {
+        // A level that did not exist before starts with zero PML fields
+        if (!old_pml[lev]) continue;
+        for (const auto& fields : {std::make_pair(pml[lev]->GetE_fp(), old_pml[lev]->GetE_fp()),
+                                   std::make_pair(pml[lev]->GetB_fp(), old_pml[lev]->GetB_fp()),
+                                   std::make_pair(pml[lev]->GetE_cp(), old_pml[lev]->GetE_cp()),
+                                   std::make_pair(pml[lev]->GetB_cp(), old_pml[lev]->GetB_cp())}) {
+            for (int i = 0; i < 3; ++i) {
+                if (fields.first[i] && fields.second[i]) {
+                    WarpXCommUtil::CopyByOverlap(*fields.first[i], *fields.second[i],
+                                                 Periodicity::NonPeriodic());
+                }
+            }
+        }
+    }
+}
+
 void
 WarpX::ComputeCostsHeuristic (amrex::Vector<std::unique_ptr<amrex::LayoutData<amrex::Real> > >& a_costs)
 {
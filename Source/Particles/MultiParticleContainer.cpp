@@ -253,6 +253,13 @@ MultiParticleContainer::ReadParameters ()
             amrex::Abort("unknown particle BC type");
         }
 
+        // Particle tiles that use less than this fraction of their allocated capacity are
+        // shrunk after each redistribution (creation and removal of particles leave the
+        // tiles with their peak capacity)
+        queryWithParser(pp, "min_tile_occupancy", m_min_tile_occupancy);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_min_tile_occupancy >= 0._rt && m_min_tile_occupancy <= 1._rt,
+            "particles.min_tile_occupancy must be between 0 and 1");
+
         ParmParse ppl("lasers");
         ppl.queryarr("names", lasers_names);
 
@@ -268,6 +275,7 @@ MultiParticleContainer::ReadParameters ()
             getWithParser(ppq, "y_size",m_qed_schwinger_y_size);
 #endif
             ppq.query("threshold_poisson_gaussian", m_qed_schwinger_threshold_poisson_gaussian);
+            queryWithParser(ppq, "min_field_fraction", m_qed_schwinger_min_field_fraction);
             queryWithParser(ppq, "xmin", m_qed_schwinger_xmin);
             queryWithParser(ppq, "xmax", m_qed_schwinger_xmax);
 #if (AMREX_SPACEDIM == 3)
@@ -399,7 +407,26 @@ MultiParticleContainer::SortParticlesByBin (amrex::IntVect bin_size)
 {
     for (auto& pc : allcontainers) {
         pc->SortParticlesByBin(bin_size);
+#ifdef WARPX_QED
+        // The particles were reordered: the indices recorded by the push are not valid anymore
+        pc->invalidateQedEvents();
+#endif
+    }
+}
+
+int
+MultiParticleContainer::SortTilesByBin (amrex::IntVect bin_size, amrex::Real locality_threshold,
+                                        bool sfc_order)
+{
+    int nsorted = 0;
+    for (auto& pc : allcontainers) {
+        const int nsorted_species = pc->SortTilesByBin(bin_size, locality_threshold, sfc_order);
+#ifdef WARPX_QED
+        if (nsorted_species > 0) pc->invalidateQedEvents();
+#endif
+        nsorted += nsorted_species;
     }
+    return nsorted;
 }
 
 void
@@ -407,6 +434,11 @@ MultiParticleContainer::Redistribute ()
 {
     for (auto& pc : allcontainers) {
         pc->Redistribute();
+#ifdef WARPX_QED
+        // The particles were reordered: the indices recorded by the push are not valid anymore
+        pc->invalidateQedEvents();
+#endif
+        if (m_min_tile_occupancy > 0._rt) pc->ShrinkTiles(m_min_tile_occupancy);
     }
 }
 
@@ -418,11 +450,24 @@ MultiParticleContainer::defineAllParticleTiles ()
     }
 }
 
+void
+MultiParticleContainer::ResizeLevelData ()
+{
+    for (auto& pc : allcontainers) {
+        pc->ResizeLevelData();
+    }
+    pc_tmp->ResizeLevelData();
+}
+
 void
 MultiParticleContainer::RedistributeLocal (const int num_ghost)
 {
     for (auto& pc : allcontainers) {
         pc->Redistribute(0, 0, 0, num_ghost);
+#ifdef WARPX_QED
+        // The particles were reordered: the indices recorded by the push are not valid anymore
+        pc->invalidateQedEvents();
+#endif
     }
 }
 
@@ -1110,6 +1155,15 @@ MultiParticleContainer::doQEDSchwinger ()
     const MultiFab & By = warpx.getBfield(level_0,1);
     const MultiFab & Bz = warpx.getBfield(level_0,2);
 
+    // The field that enters the Schwinger rate (in the frame where E and B are
+    // parallel) is at most |E|, and the rate increases with this field. Tiles
+    // where |E| is everywhere below min_field_fraction times the critical
+    // field m_e^2 c^3/(q_e hbar) can thus be skipped.
+    const amrex::Real critical_field = (PhysConst::m_e*PhysConst::c*PhysConst::c/PhysConst::q_e)
+        * (PhysConst::m_e*PhysConst::c/PhysConst::hbar);
+    const amrex::Real min_field = m_qed_schwinger_min_field_fraction*critical_field;
+    const amrex::Real min_field2 = min_field*min_field;
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
@@ -1133,6 +1187,21 @@ MultiParticleContainer::doQEDSchwinger ()
         const auto& arrBy = By[mfi].array();
         const auto& arrBz = Bz[mfi].array();
 
+        // Skip the tile if the electric field is below the threshold everywhere
+        // (this reduction is much cheaper than the evaluation of the rate)
+        if (min_field2 > 0._rt) {
+            amrex::ReduceOps<amrex::ReduceOpMax> reduce_op;
+            amrex::ReduceData<amrex::Real> reduce_data(reduce_op);
+            using ReduceTuple = typename decltype(reduce_data)::Type;
+            reduce_op.eval(box, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                return {arrEx(i,j,k)*arrEx(i,j,k) + arrEy(i,j,k)*arrEy(i,j,k)
+                        + arrEz(i,j,k)*arrEz(i,j,k)};
+            });
+            if (amrex::get<0>(reduce_data.value()) < min_field2) {continue;}
+        }
+
         const Array4<const amrex::Real> array_EMFAB [] = {arrEx,arrEy,arrEz,
                                            arrBx,arrBy,arrBz};
 
@@ -1298,10 +1367,22 @@ void MultiParticleContainer::doQedBreitWheeler (int lev,
 
             const auto np_dst_ele = dst_ele_tile.numParticles();
             const auto np_dst_pos = dst_pos_tile.numParticles();
-            const auto num_added = filterCopyTransformParticles<1>(
-                                                      dst_ele_tile, dst_pos_tile,
-                                                      src_tile, np_dst_ele, np_dst_pos,
-                                                      Filter, CopyEle, CopyPos, Transform);
+
+            // If the push recorded the photons that generate a pair, only these
+            // photons are considered. Otherwise, the filter is applied to all photons.
+            auto events = pc_source->getQedEvents(lev, pti.GetPairIndex());
+            decltype(np_dst_ele) num_added = 0;
+            if (events && static_cast<long>(src_tile.numParticles()) >= events->np) {
+                num_added = filterCopyTransformParticles<1>(dst_ele_tile, dst_pos_tile, src_tile,
+                                                            events->indices.dataPtr(),
+                                                            events->numEvents(),
+                                                            np_dst_ele, np_dst_pos,
+                                                            Filter, CopyEle, CopyPos, Transform);
+            } else {
+                num_added = filterCopyTransformParticles<1>(dst_ele_tile, dst_pos_tile,
+                                                            src_tile, np_dst_ele, np_dst_pos,
+                                                            Filter, CopyEle, CopyPos, Transform);
+            }
 
             setNewParticleIDs(dst_ele_tile, np_dst_ele, num_added);
             setNewParticleIDs(dst_pos_tile, np_dst_pos, num_added);
@@ -1361,9 +1442,21 @@ void MultiParticleContainer::doQedQuantumSync (int lev,
 
             const auto np_dst = dst_tile.numParticles();
 
-            const auto num_added =
-                filterCopyTransformParticles<1>(dst_tile, src_tile, np_dst,
-                                                Filter, CopyPhot, Transform);
+            // If the push recorded the particles that emit a photon, only these
+            // particles are considered. Otherwise, the filter is applied to all particles.
+            // (Particles appended after the push, e.g. pairs created by Breit-Wheeler,
+            // have a positive optical depth and do not invalidate the list.)
+            auto events = pc_source->getQedEvents(lev, pti.GetPairIndex());
+            decltype(np_dst) num_added = 0;
+            if (events && static_cast<long>(src_tile.numParticles()) >= events->np) {
+                num_added = filterCopyTransformParticles<1>(dst_tile, src_tile,
+                                                            events->indices.dataPtr(),
+                                                            events->numEvents(), np_dst,
+                                                            Filter, CopyPhot, Transform);
+            } else {
+                num_added = filterCopyTransformParticles<1>(dst_tile, src_tile, np_dst,
+                                                            Filter, CopyPhot, Transform);
+            }
 
             setNewParticleIDs(dst_tile, np_dst, num_added);
 
@@ -7,6 +7,7 @@
  */
 #include "PhotonParticleContainer.H"
 #include "Utils/WarpXConst.H"
+#include "Utils/WarpXAlgorithmSelection.H"
 #include "WarpX.H"
 
 // Import low-level single-particle kernels
@@ -77,22 +78,6 @@ PhotonParticleContainer::PushPX (WarpXParIter& pti,
                                  int lev, int gather_lev,
                                  amrex::Real dt, ScaleFields /*scaleFields*/, DtType a_dt_type)
 {
-    // Get cell size on gather_lev
-    const std::array<Real,3>& dx = WarpX::CellSize(std::max(gather_lev,0));
-
-    // Get box from which field is gathered.
-    // If not gathering from the finest level, the box is coarsened.
-    amrex::Box box;
-    if (lev == gather_lev) {
-        box = pti.tilebox();
-    } else {
-        const IntVect& ref_ratio = WarpX::RefRatio(gather_lev);
-        box = amrex::coarsen(pti.tilebox(),ref_ratio);
-    }
-
-    // Add guard cells to the box.
-    box.grow(ngE);
-
     auto& attribs = pti.GetAttribs();
 
     // Extract pointers to the different particle quantities
@@ -100,22 +85,48 @@ PhotonParticleContainer::PushPX (WarpXParIter& pti,
     ParticleReal* const AMREX_RESTRICT uy = attribs[PIdx::uy].dataPtr();
     ParticleReal* const AMREX_RESTRICT uz = attribs[PIdx::uz].dataPtr();
 
+    auto copyAttribs = CopyParticleAttribs(pti, tmp_particle_data, offset);
+    int do_copy = (WarpX::do_back_transformed_diagnostics &&
+                   do_back_transformed_diagnostics && a_dt_type!=DtType::SecondHalf);
+
+    const auto GetPosition = GetParticlePosition(pti, offset);
+    auto SetPosition = SetParticlePosition(pti, offset);
+
 #ifdef WARPX_QED
+    // The fields at the position of the photons are only needed to evolve
+    // the Breit-Wheeler optical depth: otherwise, photons move ballistically
+    // and the fields are neither gathered nor evaluated.
+    const bool local_has_breit_wheeler = has_breit_wheeler();
+
     BreitWheelerEvolveOpticalDepth evolve_opt;
     amrex::Real* AMREX_RESTRICT p_optical_depth_BW = nullptr;
-    const bool local_has_breit_wheeler = has_breit_wheeler();
+    int* AMREX_RESTRICT p_events = nullptr;
+    int* AMREX_RESTRICT p_num_events = nullptr;
     if (local_has_breit_wheeler) {
         evolve_opt = m_shr_p_bw_engine->build_evolve_functor();
         p_optical_depth_BW = pti.GetAttribs(particle_comps["optical_depth_BW"]).dataPtr();
+        auto events = getQedEvents(lev, pti.GetPairIndex());
+        if (events) {
+            p_events = events->indices.dataPtr();
+            p_num_events = events->num_events.dataPtr();
+        }
     }
-#endif
 
-    auto copyAttribs = CopyParticleAttribs(pti, tmp_particle_data);
-    int do_copy = (WarpX::do_back_transformed_diagnostics &&
-                   do_back_transformed_diagnostics && a_dt_type!=DtType::SecondHalf);
+    // Get cell size on gather_lev
+    const std::array<Real,3>& dx = WarpX::CellSize(std::max(gather_lev,0));
 
-    const auto GetPosition = GetParticlePosition(pti, offset);
-    auto SetPosition = SetParticlePosition(pti, offset);
+    // Get box from which field is gathered.
+    // If not gathering from the finest level, the box is coarsened.
+    amrex::Box box;
+    if (lev == gather_lev) {
+        box = pti.tilebox();
+    } else {
+        const IntVect& ref_ratio = WarpX::RefRatio(gather_lev);
+        box = amrex::coarsen(pti.tilebox(),ref_ratio);
+    }
+
+    // Add guard cells to the box.
+    box.grow(ngE);
 
     const auto getExternalE = GetExternalEField(pti, offset);
     const auto getExternalB = GetExternalBField(pti, offset);
@@ -154,6 +165,9 @@ PhotonParticleContainer::PushPX (WarpXParIter& pti,
     amrex::IndexType const bz_type = bzfab->box().ixType();
 
     const auto t_do_not_gather = do_not_gather;
+#else
+    amrex::ignore_unused(exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, lev, gather_lev);
+#endif
 
     amrex::ParallelFor(
         np_to_push,
@@ -162,28 +176,33 @@ PhotonParticleContainer::PushPX (WarpXParIter& pti,
             ParticleReal x, y, z;
             GetPosition(i, x, y, z);
 
-            amrex::ParticleReal Exp=0, Eyp=0, Ezp=0;
-            amrex::ParticleReal Bxp=0, Byp=0, Bzp=0;
-
-            if(!t_do_not_gather){
-                // first gather E and B to the particle positions
-                doGatherShapeN(x, y, z, Exp, Eyp, Ezp, Bxp, Byp, Bzp,
-                               ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
-                               ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
-                               dx_arr, xyzmin_arr, lo, n_rz_azimuthal_modes,
-                               nox, galerkin_interpolation);
-            }
-            getExternalE(i, Exp, Eyp, Ezp);
-            getExternalB(i, Bxp, Byp, Bzp);
-
 #ifdef WARPX_QED
             if (local_has_breit_wheeler) {
-                evolve_opt(ux[i], uy[i], uz[i], Exp, Eyp, Ezp, Bxp, Byp, Bzp,
-                    dt, p_optical_depth_BW[i]);
+                amrex::ParticleReal Exp=0, Eyp=0, Ezp=0;
+                amrex::ParticleReal Bxp=0, Byp=0, Bzp=0;
+
+                if(!t_do_not_gather){
+                    // first gather E and B to the particle positions
+                    doGatherShapeN(x, y, z, Exp, Eyp, Ezp, Bxp, Byp, Bzp,
+                                   ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
+                                   ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
+                                   dx_arr, xyzmin_arr, lo, n_rz_azimuthal_modes,
+                                   nox, galerkin_interpolation);
+                }
+                getExternalE(i, Exp, Eyp, Ezp);
+                getExternalB(i, Bxp, Byp, Bzp);
+
+                evolve_opt(ux[i+offset], uy[i+offset], uz[i+offset], Exp, Eyp, Ezp, Bxp, Byp, Bzp,
+                    dt, p_optical_depth_BW[i+offset]);
+                // Record the photons that will generate a pair
+                if (p_events && p_optical_depth_BW[i+offset] < 0._rt) {
+                    const int n = amrex::Gpu::Atomic::Add(p_num_events, 1);
+                    p_events[n] = static_cast<int>(i+offset);
+                }
             }
 #endif
 
-            UpdatePositionPhoton( x, y, z, ux[i], uy[i], uz[i], dt );
+            UpdatePositionPhoton( x, y, z, ux[i+offset], uy[i+offset], uz[i+offset], dt );
             SetPosition(i, x, y, z);
         }
     );
@@ -200,20 +219,80 @@ PhotonParticleContainer::Evolve (int lev,
                                  MultiFab* rho, MultiFab* crho,
                                  const MultiFab* cEx, const MultiFab* cEy, const MultiFab* cEz,
                                  const MultiFab* cBx, const MultiFab* cBy, const MultiFab* cBz,
-                                 Real t, Real dt, DtType /*a_dt_type*/)
+                                 Real t, Real dt, DtType a_dt_type)
 {
-    // This does gather, push and depose.
-    // Push and depose have been re-written for photons
-    PhysicalParticleContainer::Evolve (lev,
-                                       Ex, Ey, Ez,
-                                       Bx, By, Bz,
-                                       Ex_avg, Ey_avg, Ez_avg,
-                                       Bx_avg, By_avg, Bz_avg,
-                                       jx, jy, jz,
-                                       cjx, cjy, cjz,
-                                       rho, crho,
-                                       cEx, cEy, cEz,
-                                       cBx, cBy, cBz,
-                                       t, dt);
+    WARPX_PROFILE("PhotonParticleContainer::Evolve()");
 
+#ifdef WARPX_QED
+    if (has_breit_wheeler()) {
+        // The fields are needed by the Breit-Wheeler process:
+        // gather and push (PushPX and DepositCurrent are re-written for photons)
+        PhysicalParticleContainer::Evolve (lev,
+                                           Ex, Ey, Ez,
+                                           Bx, By, Bz,
+                                           Ex_avg, Ey_avg, Ez_avg,
+                                           Bx_avg, By_avg, Bz_avg,
+                                           jx, jy, jz,
+                                           cjx, cjy, cjz,
+                                           rho, crho,
+                                           cEx, cEy, cEz,
+                                           cBx, cBy, cBz,
+                                           t, dt);
+        return;
+    }
+#endif
+    amrex::ignore_unused(Ex_avg, Ey_avg, Ez_avg, Bx_avg, By_avg, Bz_avg,
+                         jx, jy, jz, cjx, cjy, cjz, rho, crho,
+                         cEx, cEy, cEz, cBx, cBy, cBz, t);
+
+    // Otherwise, photons move ballistically: they are pushed without
+    // gathering the fields, without the gather and deposition buffers, and
+    // they deposit neither current nor charge (photons have no charge).
+    if (do_not_push) return;
+
+    amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+
+    if (WarpX::do_back_transformed_diagnostics && do_back_transformed_diagnostics)
+    {
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            const auto np = pti.numParticles();
+            const auto t_lev = pti.GetLevel();
+            const auto index = pti.GetPairIndex();
+            tmp_particle_data.resize(finestLevel()+1);
+            for (int i = 0; i < TmpIdx::nattribs; ++i)
+                tmp_particle_data[t_lev][index][i].resize(np);
+        }
+    }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+    {
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            amrex::Gpu::synchronize();
+        }
+        Real wt = amrex::second();
+
+        const int e_is_nodal = Ex.is_nodal() and Ey.is_nodal() and Ez.is_nodal();
+        PushPX(pti, &(Ex[pti]), &(Ey[pti]), &(Ez[pti]),
+               &(Bx[pti]), &(By[pti]), &(Bz[pti]),
+               Ex.nGrow(), e_is_nodal,
+               0, pti.numParticles(), lev, lev, dt, ScaleFields(false), a_dt_type);
+
+        amrex::Gpu::synchronize();
+
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            wt = amrex::second() - wt;
+            amrex::HostDevice::Atomic::Add( &(*cost)[pti.index()], wt);
+        }
+    }
+
+    // Split particles at the end of the timestep (see PhysicalParticleContainer::Evolve)
+    if (do_splitting && (a_dt_type == DtType::SecondHalf || a_dt_type == DtType::Full) ){
+        SplitParticles(lev);
+    }
 }
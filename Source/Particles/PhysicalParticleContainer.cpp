@@ -97,6 +97,10 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
 {
     BackwardCompatibility();
 
+#ifndef AMREX_USE_GPU
+    m_partition_scratch.resize(local_buffer_flag.size());
+#endif
+
     plasma_injector = std::make_unique<PlasmaInjector>(species_id, species_name);
     physical_species = plasma_injector->getPhysicalSpecies();
     charge = plasma_injector->getCharge();
@@ -178,6 +182,9 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
 PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core)
     : WarpXParticleContainer(amr_core, 0)
 {
+#ifndef AMREX_USE_GPU
+    m_partition_scratch.resize(local_buffer_flag.size());
+#endif
     plasma_injector = std::make_unique<PlasmaInjector>();
 }
 
@@ -950,6 +957,11 @@ PhysicalParticleContainer::Evolve (int lev,
         }
     }
 
+#ifdef WARPX_QED
+    // The push records the particles that undergo a QED event
+    if (! do_not_push) resetQedEvents(lev);
+#endif
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel
 #endif
@@ -1019,7 +1031,7 @@ PhysicalParticleContainer::Evolve (int lev,
                 //    and (thus) the `np-nfine_current`/`np-nfine_gather` last particles
                 //    deposit/gather in the buffer
                 PartitionParticlesInBuffers( nfine_current, nfine_gather, np,
-                    pti, lev, current_masks, gather_masks, uxp, uyp, uzp, wp );
+                    pti, lev, current_masks, gather_masks, thread_num );
             }
 
             const long np_current = (cjx) ? nfine_current : np;
@@ -1849,10 +1861,17 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
 
     QuantumSynchrotronEvolveOpticalDepth evolve_opt;
     amrex::ParticleReal* AMREX_RESTRICT p_optical_depth_QSR = nullptr;
+    int* AMREX_RESTRICT p_events = nullptr;
+    int* AMREX_RESTRICT p_num_events = nullptr;
     const bool local_has_quantum_sync = has_quantum_sync();
     if (local_has_quantum_sync) {
         evolve_opt = m_shr_p_qs_engine->build_evolve_functor();
         p_optical_depth_QSR = pti.GetAttribs(particle_comps["optical_depth_QSR"]).dataPtr();
+        auto events = getQedEvents(lev, pti.GetPairIndex());
+        if (events) {
+            p_events = events->indices.dataPtr();
+            p_num_events = events->num_events.dataPtr();
+        }
     }
 #endif
 
@@ -1894,9 +1913,14 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
 
 #ifdef WARPX_QED
     if (local_has_quantum_sync) {
-        evolve_opt(ux[ip], uy[ip], uz[ip],
+        evolve_opt(ux[ip+offset], uy[ip+offset], uz[ip+offset],
                    Exp, Eyp, Ezp,Bxp, Byp, Bzp,
-                   dt, p_optical_depth_QSR[ip]);
+                   dt, p_optical_depth_QSR[ip+offset]);
+        // Record the particles that will emit a photon
+        if (p_events && p_optical_depth_QSR[ip+offset] < 0._rt) {
+            const int n = amrex::Gpu::Atomic::Add(p_num_events, 1);
+            p_events[n] = static_cast<int>(ip+offset);
+        }
     }
 #endif
 
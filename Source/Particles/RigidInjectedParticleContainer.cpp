@@ -59,6 +59,19 @@ void RigidInjectedParticleContainer::InitData()
     Redistribute();  // We then redistribute
 }
 
+void RigidInjectedParticleContainer::ResizeLevelData ()
+{
+    PhysicalParticleContainer::ResizeLevelData();
+
+    // The levels are synchronized when regridding: a new level starts
+    // with the injection plane of the next coarser level
+    const int nlevs = finestLevel()+1;
+    const int old_nlevs = zinject_plane_levels.size();
+    AMREX_ALWAYS_ASSERT(old_nlevs > 0);
+    done_injecting.resize(nlevs, done_injecting[old_nlevs-1]);
+    zinject_plane_levels.resize(nlevs, zinject_plane_levels[old_nlevs-1]);
+}
+
 void
 RigidInjectedParticleContainer::RemapParticles()
 {
@@ -10,9 +10,80 @@
 
 #include <AMReX_Particles.H>
 
+#include <utility>
+
 
 using namespace amrex;
 
+namespace
+{
+#ifndef AMREX_USE_GPU
+    /** \brief Stable partition of the values `v[first:last]`: the values with a zero
+     *         `flag` are compacted at the beginning of the range, and the other ones
+     *         (copied to `tmp` in the meantime) are appended after them
+     */
+    template <typename T, typename Vec>
+    void partitionComponent (T* const v, Vec& tmp, int const* const flag,
+                             long const first, long const last)
+    {
+        tmp.resize(last - first);
+        long n_front = first;
+        long n_back = 0;
+        for (long i = first; i < last; ++i) {
+            if (flag[i]) {
+                tmp[n_back++] = v[i];
+            } else {
+                v[n_front++] = v[i];
+            }
+        }
+        for (long i = 0; i < n_back; ++i) {
+            v[n_front + i] = tmp[i];
+        }
+    }
+
+    /** \brief Reorder, in place, the particles of `ptile` with indices in [begin, end)
+     *         so that the particles with a zero `flag` precede the other ones
+     *
+     * The partition is stable: the order of the particles within each part is
+     * preserved (e.g. the order of a previous sort by cell). Only the range between
+     * the first particle with a non-zero flag and the last particle with a zero flag
+     * is reordered, for the AoS and all the real and integer components (including
+     * the runtime components). Since the particles were already partitioned at the
+     * previous step and move by less than one cell, this range is typically small.
+     * The particles with a non-zero flag are moved through the arrays of `scratch`.
+     * `flag` itself is not reordered.
+     *
+     * \return index of the first particle with a non-zero flag
+     */
+    template <typename PTile, typename Scratch>
+    long partitionInPlace (PTile& ptile, int const* const flag, long const begin, long const end,
+                           Scratch& scratch)
+    {
+        long first = begin;
+        while (first < end && !flag[first]) ++first;
+        long last = end;
+        while (last > first && flag[last-1]) --last;
+        if (first == last) return first;
+
+        auto& aos = ptile.GetArrayOfStructs();
+        auto& soa = ptile.GetStructOfArrays();
+        partitionComponent(aos().dataPtr(), scratch.particles, flag, first, last);
+        for (int comp = 0; comp < soa.NumRealComps(); ++comp) {
+            partitionComponent(soa.GetRealData(comp).dataPtr(), scratch.reals, flag, first, last);
+        }
+        for (int comp = 0; comp < soa.NumIntComps(); ++comp) {
+            partitionComponent(soa.GetIntData(comp).dataPtr(), scratch.ints, flag, first, last);
+        }
+
+        long n_zero = first;
+        for (long i = first; i < last; ++i) {
+            if (!flag[i]) ++n_zero;
+        }
+        return n_zero;
+    }
+#endif
+}
+
 /* \brief Determine which particles deposit/gather in the buffer, and
  *        and reorder the particle arrays accordingly
  *
@@ -26,6 +97,13 @@ using namespace amrex;
  *     and (thus) the `np-nfine_current`/`np-nfine_gather` last particles
  *     deposit/gather in the buffer
  *
+ *  All the components of the particles (including the runtime components)
+ *  are reordered. The temporary arrays are kept from one call to the next.
+ *  On CPU, the particles are reordered in place, and only the particles
+ *  between the first one in a buffer and the last one in the fine patch are
+ *  moved. The partition is stable on CPU and GPU, so that the order of the
+ *  particles within each part (e.g. after a sort by cell) is preserved.
+ *
  * \param nfine_current number of particles that deposit to the fine patch
  *         (modified by this function)
  * \param nfine_gather number of particles that gather into the fine patch
@@ -37,8 +115,7 @@ using namespace amrex;
  *       in the deposition buffers or in the interior of the fine patch
  * \param gather_masks indicates, for each cell, whether that cell is
  *       in the gather buffers or in the interior of the fine patch
- * \param uxp, uyp, uzp, wp references to the particle momenta and weight
- *         (modified by this function)
+ * \param thread_num thread number (selects the temporary arrays)
  */
 void
 PhysicalParticleContainer::PartitionParticlesInBuffers(
@@ -46,15 +123,13 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
     WarpXParIter& pti, int const lev,
     iMultiFab const* current_masks,
     iMultiFab const* gather_masks,
-    RealVector& uxp, RealVector& uyp, RealVector& uzp, RealVector& wp)
+    int const thread_num)
 {
     WARPX_PROFILE("PhysicalParticleContainer::PartitionParticlesInBuffers");
 
-    // Initialize temporary arrays
-    Gpu::DeviceVector<int> inexflag;
+    // Temporary array for the buffer flags, reused from one call to the next
+    Gpu::DeviceVector<int>& inexflag = local_buffer_flag[thread_num];
     inexflag.resize(np);
-    Gpu::DeviceVector<long> pid;
-    pid.resize(np);
 
     // First, partition particles into the larger buffer
 
@@ -65,8 +140,18 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
     // - For each particle, find whether it is in the larger buffer,
     //   by looking up the mask. Store the answer in `inexflag`.
     amrex::ParallelFor( np, fillBufferFlag(pti, bmasks, inexflag, Geom(lev)) );
+#ifndef AMREX_USE_GPU
+    // - Reorder the particles so that the last particles are in the larger buffer
+    auto& ptile = pti.GetParticleTile();
+    int* const flag_ptr = inexflag.dataPtr();
+    auto& scratch = m_partition_scratch[thread_num];
+    long const n_fine = partitionInPlace(ptile, flag_ptr, 0, np, scratch);
+    bool const sep_is_end = (n_fine == np);
+#else
     // - Find the indices that reorder particles so that the last particles
     //   are in the larger buffer
+    Gpu::DeviceVector<long>& pid = m_partition_pid;
+    pid.resize(np);
     fillWithConsecutiveIntegers( pid );
     auto const sep = stablePartition( pid.begin(), pid.end(), inexflag );
     // At the end of this step, `pid` contains the indices that should be used to
@@ -74,6 +159,8 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
     // separates the particles that deposit/gather on the fine patch (first part)
     // and the particles that deposit/gather in the buffers (last part)
     long const n_fine = iteratorDistance(pid.begin(), sep);
+    bool const sep_is_end = (sep == pid.end());
+#endif
     // Number of particles on fine patch, i.e. outside of the larger buffer
 
     // Second, among particles that are in the larger buffer, partition
@@ -81,8 +168,8 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
 
     if (WarpX::n_current_deposition_buffer == WarpX::n_field_gather_buffer) {
         // No need to do anything if the buffers have the same size
-        nfine_current = nfine_gather = iteratorDistance(pid.begin(), sep);
-    } else if (sep == pid.end()) {
+        nfine_current = nfine_gather = n_fine;
+    } else if (sep_is_end) {
         // No need to do anything if there are no particles in the larger buffer
         nfine_current = nfine_gather = np;
     } else {
@@ -100,14 +187,22 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
         {
             // - For each particle in the large buffer, find whether it is in
             // the smaller buffer, by looking up the mask. Store the answer in `inexflag`.
+#ifndef AMREX_USE_GPU
+            auto const fill_flag = fillBufferFlag(pti, bmasks, inexflag, Geom(lev));
+            amrex::ParallelFor( np - n_fine,
+                [=] (long i) { fill_flag(i + n_fine); } );
+            long const n_fine2 = partitionInPlace(ptile, flag_ptr, n_fine, np, scratch);
+#else
             amrex::ParallelFor( np - n_fine,
                fillBufferFlagRemainingParticles(pti, bmasks, inexflag, Geom(lev), pid, n_fine) );
             auto const sep2 = stablePartition( sep, pid.end(), inexflag );
+            long const n_fine2 = iteratorDistance(pid.begin(), sep2);
+#endif
 
             if (bmasks == gather_masks) {
-                nfine_gather = iteratorDistance(pid.begin(), sep2);
+                nfine_gather = n_fine2;
             } else {
-                nfine_current = iteratorDistance(pid.begin(), sep2);
+                nfine_current = n_fine2;
             }
         }
     }
@@ -120,38 +215,37 @@ PhysicalParticleContainer::PartitionParticlesInBuffers(
         nfine_gather = 0;
     }
 
+#ifdef AMREX_USE_GPU
     // Reorder the actual particle array, using the `pid` indices
     if (nfine_current != np || nfine_gather != np)
     {
-        // Temporary array for particle AoS
-        ParticleVector particle_tmp;
-        particle_tmp.resize(np);
-
         // Copy particle AoS
         auto& aos = pti.GetArrayOfStructs();
+        ParticleVector& particle_tmp = m_partition_particle_tmp;
+        particle_tmp.resize(np);
         amrex::ParallelFor( np,
             copyAndReorder<ParticleType>( aos(), particle_tmp, pid ) );
         std::swap(aos(), particle_tmp);
 
-        // Temporary array for particle individual attributes
-        RealVector tmp;
-        tmp.resize(np);
-
-        // Copy individual attributes
-        amrex::ParallelFor( np, copyAndReorder<Real>( wp, tmp, pid ) );
-        std::swap(wp, tmp);
-        amrex::ParallelFor( np, copyAndReorder<Real>( uxp, tmp, pid ) );
-        std::swap(uxp, tmp);
-        amrex::ParallelFor( np, copyAndReorder<Real>( uyp, tmp, pid ) );
-        std::swap(uyp, tmp);
-        amrex::ParallelFor( np, copyAndReorder<Real>( uzp, tmp, pid ) );
-        std::swap(uzp, tmp);
-
-        // Make sure that the temporary arrays are not destroyed before
-        // the GPU kernels finish running
-        Gpu::streamSynchronize();
+        // Copy all the real and integer components (including the runtime ones)
+        auto& soa = pti.GetStructOfArrays();
+        RealVector& real_tmp = m_partition_real_tmp;
+        real_tmp.resize(np);
+        for (int comp = 0; comp < soa.NumRealComps(); ++comp) {
+            auto& v = soa.GetRealData(comp);
+            amrex::ParallelFor( np, copyAndReorder<ParticleReal>( v, real_tmp, pid ) );
+            std::swap(v, real_tmp);
+        }
+        IntVector& int_tmp = m_partition_int_tmp;
+        int_tmp.resize(np);
+        for (int comp = 0; comp < soa.NumIntComps(); ++comp) {
+            auto& v = soa.GetIntData(comp);
+            amrex::ParallelFor( np, copyAndReorder<int>( v, int_tmp, pid ) );
+            std::swap(v, int_tmp);
+        }
     }
-    // Make sure that the temporary arrays are not destroyed before
+    // Make sure that the temporary arrays are not modified before
     // the GPU kernels finish running
     Gpu::streamSynchronize();
+#endif
 }
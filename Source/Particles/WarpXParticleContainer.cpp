@@ -19,13 +19,65 @@
 #include "Deposition/ChargeDeposition.H"
 
 #include <AMReX_AmrParGDB.H>
+#include <AMReX_DenseBins.H>
 #include <AMReX.H>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 
 using namespace amrex;
 
+namespace
+{
+    /* \brief Index of the bin of a particle within a tile, with the bins
+     * ordered linearly (x fastest) or along a Morton curve. With the Morton
+     * order, the bits of the bin indices along each direction are interleaved,
+     * the directions with fewer bins running out of bits first. */
+    // Maximum number of bits of the Morton index of the bins (i.e. at most 2^20 bins):
+    // beyond that (e.g. for the large tiles used on GPU) the linear order is used
+    constexpr int max_sfc_bits = 20;
+
+    struct GetTileBin
+    {
+        GpuArray<Real,AMREX_SPACEDIM> plo;
+        GpuArray<Real,AMREX_SPACEDIM> dxi;
+        IntVect lo;
+        IntVect bin_size;
+        IntVect nbins;
+        IntVect nbits;
+        int max_bits;
+        bool sfc_order;
+
+        AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        unsigned int operator() (WarpXParticleContainer::ParticleType const& p) const noexcept
+        {
+            IntVect ib;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                int const i = static_cast<int>(std::floor((p.pos(idim) - plo[idim])*dxi[idim])) - lo[idim];
+                ib[idim] = amrex::max(0, amrex::min(i/bin_size[idim], nbins[idim]-1));
+            }
+            if (!sfc_order) {
+                return static_cast<unsigned int>(AMREX_D_TERM(ib[0],
+                                                 + nbins[0]*ib[1],
+                                                 + nbins[0]*nbins[1]*ib[2]));
+            }
+            unsigned int key = 0;
+            int pos = 0;
+            for (int b = 0; b < max_bits; ++b) {
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    if (b < nbits[idim]) {
+                        key |= ((static_cast<unsigned int>(ib[idim]) >> b) & 1u) << pos;
+                        ++pos;
+                    }
+                }
+            }
+            return key;
+        }
+    };
+}
+
 WarpXParIter::WarpXParIter (ContainerType& pc, int level)
     : amrex::ParIter<0,0,PIdx::nattribs>(pc, level,
              MFItInfo().SetDynamic(WarpX::do_dynamic_scheduling))
@@ -65,6 +117,7 @@ WarpXParticleContainer::WarpXParticleContainer (AmrCore* amr_core, int ispecies)
     local_jx.resize(num_threads);
     local_jy.resize(num_threads);
     local_jz.resize(num_threads);
+    local_buffer_flag.resize(num_threads);
 }
 
 void
@@ -96,15 +149,18 @@ WarpXParticleContainer::AllocData ()
 }
 
 void
-WarpXParticleContainer::AddNParticles (int /*lev*/,
+WarpXParticleContainer::AddNParticles (int lev,
                                        int n, const ParticleReal* x, const ParticleReal* y, const ParticleReal* z,
                                        const ParticleReal* vx, const ParticleReal* vy, const ParticleReal* vz,
-                                       int nattr, const ParticleReal* attr, int uniqueparticles, amrex::Long id)
+                                       int nattr, const ParticleReal* attr, int uniqueparticles, amrex::Long id,
+                                       bool local)
 {
     // nattr is unused below but needed in the BL_ASSERT
     amrex::ignore_unused(nattr);
 
     BL_ASSERT(nattr == 1);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!local || uniqueparticles,
+        "AddNParticles: local insertion requires unique particles");
 
     const ParticleReal* weight = attr;
 
@@ -126,9 +182,23 @@ WarpXParticleContainer::AddNParticles (int /*lev*/,
         }
     }
 
-    //  Add to grid 0 and tile 0
-    // Redistribute() will move them to proper places.
-    auto& particle_tile = DefineAndReturnParticleTile(0, 0, 0);
+    // Add to grid 0 and tile 0, or to the first local tile of level lev for a
+    // local insertion. Redistribute() will move them to proper places.
+    int ins_lev = 0;
+    int ins_grid = 0;
+    int ins_tile = 0;
+    if (local) {
+        ins_lev = lev;
+        MFIter mfi = MakeMFIter(lev);
+        if (mfi.isValid()) {
+            ins_grid = mfi.index();
+            ins_tile = mfi.LocalTileIndex();
+        } else {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(n == 0,
+                "AddNParticles: local insertion on a rank that owns no box");
+        }
+    }
+    auto& particle_tile = DefineAndReturnParticleTile(ins_lev, ins_grid, ins_tile);
 
     using PinnedTile = ParticleTile<NStructReal, NStructInt, NArrayReal, NArrayInt,
                                     amrex::PinnedArenaAllocator>;
@@ -167,7 +237,7 @@ WarpXParticleContainer::AddNParticles (int /*lev*/,
 #endif
 
         if ( (NumRuntimeRealComps()>0) || (NumRuntimeIntComps()>0) ){
-            DefineAndReturnParticleTile(0, 0, 0);
+            DefineAndReturnParticleTile(ins_lev, ins_grid, ins_tile);
         }
 
         pinned_tile.push_back(p);
@@ -181,7 +251,7 @@ WarpXParticleContainer::AddNParticles (int /*lev*/,
         pinned_tile.push_back_real(PIdx::uz,     vz + ibegin,     vz + iend);
 
         if ( (NumRuntimeRealComps()>0) || (NumRuntimeIntComps()>0) ){
-            DefineAndReturnParticleTile(0, 0, 0);
+            DefineAndReturnParticleTile(ins_lev, ins_grid, ins_tile);
         }
 
         for (int comp = PIdx::uz+1; comp < PIdx::nattribs; ++comp)
@@ -203,11 +273,23 @@ WarpXParticleContainer::AddNParticles (int /*lev*/,
             pinned_tile.push_back_real(i, 0.0);
         }
 
-        particle_tile.resize(pinned_tile.numParticles());
-        amrex::copyParticles(particle_tile, pinned_tile);
+        // Append to the particles already in the tile, which for a local
+        // insertion are typically those injected at the previous steps.
+        auto old_np = particle_tile.numParticles();
+        auto new_np = old_np + pinned_tile.numParticles();
+        particle_tile.resize(new_np);
+        amrex::copyParticles(particle_tile, pinned_tile,
+                             0, old_np, pinned_tile.numParticles());
     }
 
-    Redistribute();
+    if (local && finestLevel() == 0) {
+        // Only exchange particles with the ranks that own a box within one cell
+        // of the boxes of this rank. With mesh refinement, the particles may also
+        // need to move to another level, which requires the global Redistribute.
+        Redistribute(lev, lev, 0, 1);
+    } else {
+        Redistribute();
+    }
 }
 
 /* \brief Current Deposition for thread thread_num
@@ -403,6 +485,25 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
                 jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
                 WarpX::n_rz_azimuthal_modes );
         }
+#if !defined(AMREX_USE_GPU) && !defined(WARPX_DIM_RZ)
+    } else if (WarpX::do_vectorized_deposition) {
+        if        (WarpX::nox == 1){
+            doVectorizedDepositionShapeN<1>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q);
+        } else if (WarpX::nox == 2){
+            doVectorizedDepositionShapeN<2>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q);
+        } else if (WarpX::nox == 3){
+            doVectorizedDepositionShapeN<3>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q);
+        }
+#endif
     } else {
         if        (WarpX::nox == 1){
             doDepositionShapeN<1>(
@@ -947,6 +1048,54 @@ void WarpXParticleContainer::defineAllParticleTiles () noexcept
     }
 }
 
+void
+WarpXParticleContainer::ResizeLevelData ()
+{
+    tmp_particle_data.resize(finestLevel()+1);
+#ifdef WARPX_QED
+    m_qed_events.resize(finestLevel()+1);
+#endif
+}
+
+#ifdef WARPX_QED
+void
+WarpXParticleContainer::resetQedEvents (int lev)
+{
+    if (!has_quantum_sync() && !has_breit_wheeler()) return;
+
+    m_qed_events.resize(finestLevel()+1);
+    // Tiles that are not pushed keep an invalid list
+    for (auto& kv : m_qed_events[lev]) kv.second.np = -1;
+
+    for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+    {
+        auto& events = m_qed_events[lev][pti.GetPairIndex()];
+        events.np = pti.numParticles();
+        events.indices.resize(events.np);
+        events.num_events.resize(1);
+        const int zero = 0;
+        amrex::Gpu::htod_memcpy(events.num_events.dataPtr(), &zero, sizeof(int));
+    }
+}
+
+WarpXParticleContainer::QedEventTile*
+WarpXParticleContainer::getQedEvents (int lev, PairIndex const& index)
+{
+    if (lev >= static_cast<int>(m_qed_events.size())) return nullptr;
+    auto it = m_qed_events[lev].find(index);
+    if (it == m_qed_events[lev].end() || it->second.np < 0) return nullptr;
+    return &(it->second);
+}
+
+void
+WarpXParticleContainer::invalidateQedEvents () noexcept
+{
+    for (auto& events_lev : m_qed_events) {
+        for (auto& kv : events_lev) kv.second.np = -1;
+    }
+}
+#endif
+
 // This function is called in Redistribute, just after locate
 void
 WarpXParticleContainer::particlePostLocate(ParticleType& p,
@@ -975,9 +1124,11 @@ WarpXParticleContainer::ApplyBoundaryConditions (ParticleBC boundary_conditions)
     WARPX_PROFILE("WarpXParticleContainer::ApplyBoundaryConditions()");
     for (int lev = 0; lev <= finestLevel(); ++lev)
     {
-        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        // No field data is needed here: loop over the particle tiles directly
+        for (auto& kv : GetParticles(lev))
         {
-            auto GetPosition = GetParticlePosition(pti);
+            ParticleTileType& ptile = kv.second;
+            auto GetPosition = GetParticlePosition(ptile);
             const Real xmin = Geom(lev).ProbLo(0);
             const Real xmax = Geom(lev).ProbHi(0);
 #ifdef WARPX_DIM_3D
@@ -987,12 +1138,11 @@ WarpXParticleContainer::ApplyBoundaryConditions (ParticleBC boundary_conditions)
             const Real zmin = Geom(lev).ProbLo(AMREX_SPACEDIM-1);
             const Real zmax = Geom(lev).ProbHi(AMREX_SPACEDIM-1);
 
-            ParticleTileType& ptile = ParticlesAt(lev, pti);
             ParticleType * const pp = ptile.GetArrayOfStructs()().data();
 
             // Loop over particles and apply BC to each particle
             amrex::ParallelFor(
-                pti.numParticles(),
+                ptile.numParticles(),
                 [=] AMREX_GPU_DEVICE (long i) {
                     ParticleType& p = pp[i];
                     ParticleReal x, y, z;
@@ -1011,3 +1161,100 @@ WarpXParticleContainer::ApplyBoundaryConditions (ParticleBC boundary_conditions)
         }
     }
 }
+
+int
+WarpXParticleContainer::SortTilesByBin (IntVect bin_size, Real locality_threshold, bool sfc_order)
+{
+    WARPX_PROFILE("WarpXParticleContainer::SortTilesByBin()");
+
+    int nsorted = 0;
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+        const auto plo = Geom(lev).ProbLoArray();
+        const auto dxi = Geom(lev).InvCellSizeArray();
+
+        for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            ParticleTileType& ptile = ParticlesAt(lev, pti);
+            const int np = ptile.numParticles();
+            if (np < 2) continue;
+
+            // Number of bins along each direction, and number of bits of their index
+            const Box& box = pti.tilebox();
+            GetTileBin get_bin;
+            get_bin.plo = plo;
+            get_bin.dxi = dxi;
+            get_bin.lo = box.smallEnd();
+            get_bin.bin_size = bin_size;
+            get_bin.max_bits = 0;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                get_bin.nbins[idim] = (box.length(idim) + bin_size[idim] - 1)/bin_size[idim];
+                get_bin.nbits[idim] = 0;
+                while ((1 << get_bin.nbits[idim]) < get_bin.nbins[idim]) ++get_bin.nbits[idim];
+                get_bin.max_bits = std::max(get_bin.max_bits, get_bin.nbits[idim]);
+            }
+            get_bin.sfc_order = sfc_order && get_bin.nbits.sum() <= max_sfc_bits;
+            const int nbins = get_bin.sfc_order ? (1 << get_bin.nbits.sum())
+                                                : get_bin.nbins.product();
+
+            const ParticleType* AMREX_RESTRICT pstruct = ptile.GetArrayOfStructs()().data();
+
+            if (locality_threshold >= 0._rt) {
+                // Count the particles whose bin comes before the bin of the previous particle
+                ReduceOps<ReduceOpSum> reduce_op;
+                ReduceData<int> reduce_data(reduce_op);
+                using ReduceTuple = typename decltype(reduce_data)::Type;
+                reduce_op.eval(np-1, reduce_data,
+                    [=] AMREX_GPU_DEVICE (int i) -> ReduceTuple
+                    {
+                        return {(get_bin(pstruct[i+1]) < get_bin(pstruct[i])) ? 1 : 0};
+                    });
+                const int n_out_of_order = amrex::get<0>(reduce_data.value());
+                if (n_out_of_order <= locality_threshold*(np-1)) continue;
+            }
+
+            DenseBins<ParticleType> bins;
+            bins.build(np, pstruct, nbins, get_bin);
+            ReorderParticles(lev, pti, bins.permutationPtr());
+            ++nsorted;
+        }
+    }
+    return nsorted;
+}
+
+void
+WarpXParticleContainer::ShrinkTiles (Real min_occupancy)
+{
+    WARPX_PROFILE("WarpXParticleContainer::ShrinkTiles()");
+
+    for (int lev = 0; lev <= finestLevel(); ++lev)
+    {
+        for (auto& kv : GetParticles(lev))
+        {
+            ParticleTileType& ptile = kv.second;
+            const auto capacity = ptile.GetArrayOfStructs()().capacity();
+            if (ptile.numParticles() < min_occupancy*capacity) {
+                ptile.shrink_to_fit();
+            }
+        }
+    }
+}
+
+void
+WarpXParticleContainer::MemoryUsage (Long& live_bytes, Long& allocated_bytes) const
+{
+    // Size of one particle: particle struct, and runtime real and int components
+    const Long particle_bytes = sizeof(ParticleType)
+        + NumRealComps()*sizeof(ParticleReal) + NumIntComps()*sizeof(int);
+
+    live_bytes = 0;
+    allocated_bytes = 0;
+    for (int lev = 0; lev < static_cast<int>(GetParticles().size()); ++lev)
+    {
+        for (auto const& kv : GetParticles(lev))
+        {
+            live_bytes += kv.second.numParticles()*particle_bytes;
+            allocated_bytes += kv.second.capacity();
+        }
+    }
+}
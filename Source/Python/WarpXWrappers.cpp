@@ -16,55 +16,82 @@
 #include <AMReX.H>
 #include <AMReX_BLProfiler.H>
 
+#include <map>
+#include <vector>
+
 
 namespace
 {
-    amrex::Real** getMultiFabPointers(const amrex::MultiFab& mf, int *num_boxes, int *ncomps, int **ngrowvect, int **shapes)
-    {
-        *ncomps = mf.nComp();
-        *num_boxes = mf.local_size();
+    /** Pointers to the data of the boxes of a MultiFab, with their shapes and lower
+     *  corners, as returned to Python. The views are built once and reused until the
+     *  fields are reallocated (see WarpX::fields_version). */
+    struct MultiFabView
+    {
+        std::vector<amrex::Real*> data;
+        std::vector<int> shapes;
+        std::vector<int> lovects;
+        std::vector<int> ngrow;
+    };
+
+    std::map<const amrex::MultiFab*, MultiFabView> multifab_views;
+    int multifab_views_version = -1;
+
+    MultiFabView& getMultiFabView (const amrex::MultiFab& mf)
+    {
+        if (multifab_views_version != WarpX::fields_version) {
+            // The MultiFabs may have been reallocated: all the views are stale
+            multifab_views.clear();
+            multifab_views_version = WarpX::fields_version;
+        }
+        auto found = multifab_views.find(&mf);
+        if (found != multifab_views.end()) return found->second;
+
+        MultiFabView& view = multifab_views[&mf];
+        const int num_boxes = mf.local_size();
         int shapesize = AMREX_SPACEDIM;
-        *ngrowvect = static_cast<int*>(malloc(sizeof(int)*shapesize));
+        if (mf.nComp() > 1) shapesize += 1;
+        view.ngrow.resize(AMREX_SPACEDIM);
         for (int j = 0; j < AMREX_SPACEDIM; ++j) {
-            (*ngrowvect)[j] = mf.nGrow(j);
+            view.ngrow[j] = mf.nGrow(j);
         }
-        if (mf.nComp() > 1) shapesize += 1;
-        *shapes = static_cast<int*>(malloc(sizeof(int)*shapesize * (*num_boxes)));
-        auto data =
-            static_cast<amrex::Real**>(malloc((*num_boxes) * sizeof(amrex::Real*)));
+        view.data.resize(num_boxes);
+        view.shapes.resize(shapesize*num_boxes);
+        view.lovects.resize(AMREX_SPACEDIM*num_boxes);
 
-#ifdef AMREX_USE_OMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
         for ( amrex::MFIter mfi(mf, false); mfi.isValid(); ++mfi ) {
             int i = mfi.LocalIndex();
-            data[i] = (amrex::Real*) mf[mfi].dataPtr();
+            view.data[i] = const_cast<amrex::Real*>(mf[mfi].dataPtr());
+            const int* loVect = mf[mfi].loVect();
             for (int j = 0; j < AMREX_SPACEDIM; ++j) {
-                (*shapes)[shapesize*i+j] = mf[mfi].box().length(j);
+                view.shapes[shapesize*i+j] = mf[mfi].box().length(j);
+                view.lovects[AMREX_SPACEDIM*i+j] = loVect[j];
             }
-            if (mf.nComp() > 1) (*shapes)[shapesize*i+AMREX_SPACEDIM] = mf.nComp();
+            if (mf.nComp() > 1) view.shapes[shapesize*i+AMREX_SPACEDIM] = mf.nComp();
         }
-        return data;
+        return view;
+    }
+    // The returned arrays are owned by the view, and must not be freed by the caller
+    amrex::Real** getMultiFabPointers(const amrex::MultiFab& mf, int *num_boxes, int *ncomps, int **ngrowvect, int **shapes)
+    {
+        MultiFabView& view = getMultiFabView(mf);
+        *ncomps = mf.nComp();
+        *num_boxes = mf.local_size();
+        *ngrowvect = view.ngrow.data();
+        *shapes = view.shapes.data();
+        return view.data.data();
     }
     int* getMultiFabLoVects(const amrex::MultiFab& mf, int *num_boxes, int **ngrowvect)
     {
-        int shapesize = AMREX_SPACEDIM;
-        *ngrowvect = static_cast<int*>(malloc(sizeof(int)*shapesize));
-        for (int j = 0; j < AMREX_SPACEDIM; ++j) {
-            (*ngrowvect)[j] = mf.nGrow(j);
-        }
+        MultiFabView& view = getMultiFabView(mf);
         *num_boxes = mf.local_size();
-        int *loVects = (int*) malloc((*num_boxes)*AMREX_SPACEDIM * sizeof(int));
-
-        int i = 0;
-        for ( amrex::MFIter mfi(mf, false); mfi.isValid(); ++mfi, ++i ) {
-            const int* loVect = mf[mfi].loVect();
-            for (int j = 0; j < AMREX_SPACEDIM; ++j) {
-                loVects[AMREX_SPACEDIM*i+j] = loVect[j];
-            }
-        }
-        return loVects;
+        *ngrowvect = view.ngrow.data();
+        return view.lovects.data();
     }
+
+    // Pointers to the particle data of each tile, as returned to Python;
+    // they are valid until the next call.
+    std::vector<amrex::ParticleReal*> particle_tile_data;
+    std::vector<int> particle_tile_sizes;
     // Copy the nodal flag data and return the copy:
     // the nodal flag data should not be modifiable from Python.
     int* getFieldNodalFlagData ( const amrex::MultiFab& mf )
@@ -208,12 +235,13 @@ extern "C"
     void warpx_addNParticles(int speciesnumber, int lenx,
                              amrex::ParticleReal const * x, amrex::ParticleReal const * y, amrex::ParticleReal const * z,
                              amrex::ParticleReal const * vx, amrex::ParticleReal const * vy, amrex::ParticleReal const * vz,
-                             int nattr, amrex::ParticleReal const * attr, int uniqueparticles)
+                             int nattr, amrex::ParticleReal const * attr, int uniqueparticles,
+                             int local)
     {
         auto & mypc = WarpX::GetInstance().GetPartContainer();
         auto & myspc = mypc.GetParticleContainer(speciesnumber);
         const int lev = 0;
-        myspc.AddNParticles(lev, lenx, x, y, z, vx, vy, vz, nattr, attr, uniqueparticles);
+        myspc.AddNParticles(lev, lenx, x, y, z, vx, vy, vz, nattr, attr, uniqueparticles, -1, local);
     }
 
     void warpx_ConvertLabParamsToBoost()
@@ -245,6 +273,10 @@ extern "C"
         return dx[dir];
     }
 
+    int warpx_getFieldsVersion() {
+        return WarpX::fields_version;
+    }
+
     long warpx_getNumParticles(int speciesnumber) {
         const auto & mypc = WarpX::GetInstance().GetPartContainer();
         const auto & myspc = mypc.GetParticleContainer(speciesnumber);
@@ -362,21 +394,16 @@ extern "C"
         const auto & mypc = WarpX::GetInstance().GetPartContainer();
         auto & myspc = mypc.GetParticleContainer(speciesnumber);
 
-        int i = 0;
-        for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti, ++i) {}
-
-        // *num_tiles = myspc.numLocalTilesAtLevel(lev);
-        *num_tiles = i;
-        *particles_per_tile = (int*) malloc(*num_tiles*sizeof(int));
-
-        amrex::ParticleReal** data = (amrex::ParticleReal**) malloc(*num_tiles*sizeof(typename WarpXParticleContainer::ParticleType*));
-        i = 0;
-        for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti, ++i) {
+        particle_tile_data.clear();
+        particle_tile_sizes.clear();
+        for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti) {
             auto& aos = pti.GetArrayOfStructs();
-            data[i] = (amrex::ParticleReal*) aos.data();
-            (*particles_per_tile)[i] = pti.numParticles();
+            particle_tile_data.push_back((amrex::ParticleReal*) aos.data());
+            particle_tile_sizes.push_back(pti.numParticles());
         }
-        return data;
+        *num_tiles = static_cast<int>(particle_tile_data.size());
+        *particles_per_tile = particle_tile_sizes.data();
+        return particle_tile_data.data();
     }
 
     amrex::ParticleReal** warpx_getParticleArrays(int speciesnumber, int comp, int lev,
@@ -384,21 +411,16 @@ extern "C"
         const auto & mypc = WarpX::GetInstance().GetPartContainer();
         auto & myspc = mypc.GetParticleContainer(speciesnumber);
 
-        int i = 0;
-        for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti, ++i) {}
-
-        // *num_tiles = myspc.numLocalTilesAtLevel(lev);
-        *num_tiles = i;
-        *particles_per_tile = (int*) malloc(*num_tiles*sizeof(int));
-
-        amrex::ParticleReal** data = (amrex::ParticleReal**) malloc(*num_tiles*sizeof(amrex::ParticleReal*));
-        i = 0;
-        for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti, ++i) {
+        particle_tile_data.clear();
+        particle_tile_sizes.clear();
+        for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti) {
             auto& soa = pti.GetStructOfArrays();
-            data[i] = (amrex::ParticleReal*) soa.GetRealData(comp).dataPtr();
-            (*particles_per_tile)[i] = pti.numParticles();
+            particle_tile_data.push_back((amrex::ParticleReal*) soa.GetRealData(comp).dataPtr());
+            particle_tile_sizes.push_back(pti.numParticles());
         }
-        return data;
+        *num_tiles = static_cast<int>(particle_tile_data.size());
+        *particles_per_tile = particle_tile_sizes.data();
+        return particle_tile_data.data();
     }
 
     void warpx_ComputeDt () {
@@ -74,7 +74,8 @@ extern "C" {
                              amrex::ParticleReal const * vz,
                              int nattr,
                              amrex::ParticleReal const * attr,
-                             int uniqueparticles);
+                             int uniqueparticles,
+                             int local);
 
     void warpx_ConvertLabParamsToBoost();
 
@@ -84,6 +85,8 @@ extern "C" {
 
     amrex::Real warpx_getProbHi(int dir);
 
+    int warpx_getFieldsVersion();
+
     long warpx_getNumParticles(int speciesnumber);
 
     amrex::ParticleReal** warpx_getParticleStructs(int speciesnumber, int lev,
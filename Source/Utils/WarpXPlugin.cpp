@@ -0,0 +1,81 @@
+/* Copyright 2021
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "WarpXPlugin.H"
+#include "WarpXProfilerWrapper.H"
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+
+#ifndef _WIN32
+#   include <dlfcn.h>
+#endif
+
+#include <memory>
+
+namespace
+{
+    struct LoadedPlugin
+    {
+        std::unique_ptr<WarpXPlugin> plugin;
+        void* handle = nullptr;
+    };
+
+    std::vector<LoadedPlugin> loaded_plugins;
+}
+
+void
+WarpXPlugins::Load (const std::vector<std::string>& libraries)
+{
+    // The plugins are loaded once, even if several WarpX instances are created
+    if (libraries.empty() || !loaded_plugins.empty()) return;
+#ifdef _WIN32
+    amrex::Abort("warpx.plugins is not supported on Windows");
+#else
+    amrex::ExecOnFinalize(WarpXPlugins::Finalize);
+    for (const auto& library : libraries) {
+        void* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (handle == nullptr) {
+            amrex::Abort("warpx.plugins: cannot load " + library + ": " + dlerror());
+        }
+        auto create = reinterpret_cast<WARPX_PLUGIN_CREATE_FUNC>(
+            dlsym(handle, "warpx_plugin_create"));
+        if (create == nullptr) {
+            dlclose(handle);
+            amrex::Abort("warpx.plugins: " + library + " does not export warpx_plugin_create");
+        }
+        LoadedPlugin p;
+        p.plugin.reset(create());
+        p.handle = handle;
+        loaded_plugins.push_back(std::move(p));
+        amrex::Print() << "Loaded plugin " << library << "\n";
+    }
+#endif
+}
+
+void
+WarpXPlugins::CallHook (void (WarpXPlugin::*hook)(WarpX&), WarpX& warpx)
+{
+    if (loaded_plugins.empty()) return;
+    WARPX_PROFILE("WarpXPlugins::CallHook()");
+    for (auto& p : loaded_plugins) {
+        ((*p.plugin).*hook)(warpx);
+    }
+}
+
+void
+WarpXPlugins::Finalize ()
+{
+#ifndef _WIN32
+    // The plugins are destroyed in reverse order, before their library is closed
+    while (!loaded_plugins.empty()) {
+        auto& p = loaded_plugins.back();
+        p.plugin.reset();
+        dlclose(p.handle);
+        loaded_plugins.pop_back();
+    }
+#endif
+}
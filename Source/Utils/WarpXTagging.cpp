@@ -10,31 +10,133 @@
 #include <AMReX_BoxIterator.H>
 #include <array>
 #include <algorithm>
+#include <cmath>
 
 using namespace amrex;
 
 void
-WarpX::ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/)
+WarpX::ErrorEst (int lev, TagBoxArray& tags, Real time, int /*ngrow*/)
 {
     const Real* problo = Geom(lev).ProbLo();
     const Real* dx = Geom(lev).CellSize();
 
+    if (tag_static_box) {
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-    for (MFIter mfi(tags); mfi.isValid(); ++mfi)
-    {
-        auto& fab = tags[mfi];
-        const Box& bx = fab.box();
-        for (BoxIterator bi(bx); bi.ok(); ++bi)
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi)
         {
-            const IntVect& cell = bi();
-            RealVect pos {AMREX_D_DECL((cell[0]+0.5_rt)*dx[0]+problo[0],
-                                       (cell[1]+0.5_rt)*dx[1]+problo[1],
-                                       (cell[2]+0.5_rt)*dx[2]+problo[2])};
-            if (pos > fine_tag_lo && pos < fine_tag_hi) {
-                fab(cell) = TagBox::SET;
+            auto& fab = tags[mfi];
+            const Box& bx = fab.box();
+            for (BoxIterator bi(bx); bi.ok(); ++bi)
+            {
+                const IntVect& cell = bi();
+                RealVect pos {AMREX_D_DECL((cell[0]+0.5_rt)*dx[0]+problo[0],
+                                           (cell[1]+0.5_rt)*dx[1]+problo[1],
+                                           (cell[2]+0.5_rt)*dx[2]+problo[2])};
+                if (pos > fine_tag_lo && pos < fine_tag_hi) {
+                    fab(cell) = TagBox::SET;
+                }
             }
         }
     }
+
+    // The criteria that depend on the particles and fields are only evaluated
+    // during the simulation (DynamicRegrid): when the grids are first created,
+    // the particles are not initialized yet.
+    const bool tag_particles = (tag_particles_per_cell > 0) && (istep[0] > 0);
+    const bool tag_rho = (tag_rho_threshold > 0.) && (istep[0] > 0);
+    const bool tag_gradient = (tag_field_gradient_threshold > 0.) && (istep[0] > 0);
+    const bool tag_function = static_cast<bool>(tag_function_parser);
+    if (!tag_particles && !tag_rho && !tag_gradient && !tag_function) return;
+
+    // Number of macroparticles per cell (all species)
+    std::unique_ptr<MultiFab> ppc;
+    if (tag_particles) {
+        ppc = std::make_unique<MultiFab>(boxArray(lev), DistributionMap(lev), 1, 0);
+        ppc->setVal(0.);
+        for (int i = 0; i < mypc->nSpecies(); ++i) {
+            mypc->GetParticleContainer(i).Increment(*ppc, lev);
+        }
+    }
+    // Charge density, on the nodes
+    std::unique_ptr<MultiFab> rho;
+    if (tag_rho) {
+        rho = mypc->GetChargeDensity(lev);
+    }
+
+    const Real min_ppc = static_cast<Real>(tag_particles_per_cell);
+    const Real rho_threshold = tag_rho_threshold;
+    const Real gradient_threshold = tag_field_gradient_threshold;
+    HostDeviceParser<4> tag_func;
+    if (tag_function) tag_func = getParser(tag_function_parser);
+    const GpuArray<Real,AMREX_SPACEDIM> xlo {AMREX_D_DECL(problo[0], problo[1], problo[2])};
+    const GpuArray<Real,AMREX_SPACEDIM> cell_size {AMREX_D_DECL(dx[0], dx[1], dx[2])};
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(tags, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const IntVect vhi = mfi.validbox().bigEnd();
+        Array4<char> const& tag_arr = tags.array(mfi);
+
+        Array4<Real const> ppc_arr, rho_arr, Ex_arr, Ey_arr, Ez_arr;
+        if (tag_particles) ppc_arr = ppc->const_array(mfi);
+        if (tag_rho) rho_arr = rho->const_array(mfi);
+        if (tag_gradient) {
+            Ex_arr = Efield_fp[lev][0]->const_array(mfi);
+            Ey_arr = Efield_fp[lev][1]->const_array(mfi);
+            Ez_arr = Efield_fp[lev][2]->const_array(mfi);
+        }
+
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            bool tag = false;
+
+            if (tag_particles) {
+                tag = tag || (ppc_arr(i,j,k) >= min_ppc);
+            }
+            if (tag_rho) {
+                tag = tag || (std::abs(rho_arr(i,j,k)) >= rho_threshold);
+            }
+            if (tag_gradient) {
+                // Jump of each component of E towards the next cell, in each direction
+                // (towards the previous cell in the last cell of the box, since the
+                // guard cells are not necessarily filled, e.g. at the domain boundary)
+                const IntVect shift[AMREX_SPACEDIM] = {AMREX_D_DECL(IntVect(AMREX_D_DECL(1,0,0)),
+                                                                    IntVect(AMREX_D_DECL(0,1,0)),
+                                                                    IntVect(AMREX_D_DECL(0,0,1)))};
+                const IntVect cell(AMREX_D_DECL(i,j,k));
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    const int sign = (cell[idim] < vhi[idim]) ? 1 : -1;
+                    const int ii = i + sign*shift[idim][0];
+                    const int jj = j + sign*shift[idim][1];
+#if (AMREX_SPACEDIM == 3)
+                    const int kk = k + sign*shift[idim][2];
+#else
+                    const int kk = k;
+#endif
+                    tag = tag || (std::abs(Ex_arr(ii,jj,kk) - Ex_arr(i,j,k)) > gradient_threshold)
+                              || (std::abs(Ey_arr(ii,jj,kk) - Ey_arr(i,j,k)) > gradient_threshold)
+                              || (std::abs(Ez_arr(ii,jj,kk) - Ez_arr(i,j,k)) > gradient_threshold);
+                }
+            }
+            if (tag_function) {
+                // Position of the cell center (x and z in 2D)
+                const Real x = xlo[0] + (i+0.5_rt)*cell_size[0];
+#if (AMREX_SPACEDIM == 3)
+                const Real y = xlo[1] + (j+0.5_rt)*cell_size[1];
+                const Real z = xlo[2] + (k+0.5_rt)*cell_size[2];
+#else
+                const Real y = 0._rt;
+                const Real z = xlo[1] + (j+0.5_rt)*cell_size[1];
+#endif
+                tag = tag || (tag_func(x, y, z, time) > 0._rt);
+            }
+
+            if (tag) tag_arr(i,j,k) = TagBox::SET;
+        });
+    }
 }
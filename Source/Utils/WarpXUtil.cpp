@@ -82,7 +82,9 @@ void ConvertLabParamsToBoost()
 
 
     pp_amr.query("max_level", max_level);
-    if (max_level > 0){
+    // The static refined patch is optional with dynamic tagging criteria
+    const bool convert_fine_tag = (max_level > 0) && pp_wpx.contains("fine_tag_lo");
+    if (convert_fine_tag){
       pp_wpx.getarr("fine_tag_lo", fine_tag_lo);
       pp_wpx.getarr("fine_tag_hi", fine_tag_hi);
     }
@@ -102,7 +104,7 @@ void ConvertLabParamsToBoost()
             convert_factor = 1./( gamma_boost * ( 1 - beta_boost ) );
             prob_lo[idim] *= convert_factor;
             prob_hi[idim] *= convert_factor;
-            if (max_level > 0){
+            if (convert_fine_tag){
               fine_tag_lo[idim] *= convert_factor;
               fine_tag_hi[idim] *= convert_factor;
             }
@@ -114,7 +116,7 @@ void ConvertLabParamsToBoost()
 
     pp_geom.addarr("prob_lo", prob_lo);
     pp_geom.addarr("prob_hi", prob_hi);
-    if (max_level > 0){
+    if (convert_fine_tag){
       pp_wpx.addarr("fine_tag_lo", fine_tag_lo);
       pp_wpx.addarr("fine_tag_hi", fine_tag_hi);
     }
@@ -268,6 +270,9 @@ getWithParser (const amrex::ParmParse& a_pp, char const * const str, amrex::Real
  * entire radial extent.
  * The grid can be divided up along z, but the number of blocks
  * must be >= the number of processors.
+ * With psatd.distributed_hankel = 1, the Hankel transforms are distributed
+ * over the radial blocks: the grid can then be divided up along r too and
+ * the user input for the block sizes is kept as is.
  */
 void CheckGriddingForRZSpectral ()
 {
@@ -282,6 +287,13 @@ void CheckGriddingForRZSpectral ()
     if (maxwell_solver_id != MaxwellSolverAlgo::PSATD)
         return;
 
+    // no constraint on the blocks when the Hankel transforms are distributed
+    ParmParse pp_psatd("psatd");
+    int distributed_hankel = 0;
+    pp_psatd.query("distributed_hankel", distributed_hankel);
+    if (distributed_hankel)
+        return;
+
     int max_level;
     Vector<int> n_cell(AMREX_SPACEDIM, -1);
 
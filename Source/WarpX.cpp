@@ -19,6 +19,7 @@
 #include "Utils/WarpXUtil.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXPlugin.H"
 
 #include <AMReX_ParmParse.H>
 #include <AMReX_MultiFabUtil.H>
@@ -107,6 +108,8 @@ int WarpX::num_mirrors = 0;
 
 IntervalsParser WarpX::sort_intervals;
 amrex::IntVect WarpX::sort_bin_size(AMREX_D_DECL(1,1,1));
+amrex::Real WarpX::sort_locality_threshold = -1._rt;
+bool WarpX::sort_space_filling_curve = false;
 
 bool WarpX::do_back_transformed_diagnostics = false;
 std::string WarpX::lab_data_directory = "lab_frame_data";
@@ -122,11 +125,17 @@ Real WarpX::particle_slice_width_lab = 0.0_rt;
 bool WarpX::do_dynamic_scheduling = true;
 
 int WarpX::do_electrostatic;
+int WarpX::poisson_solver_id;
 Real WarpX::self_fields_required_precision = 1.e-11_rt;
 int WarpX::self_fields_max_iters = 200;
 
 int WarpX::do_subcycling = 0;
 bool WarpX::safe_guard_cells = 0;
+bool WarpX::do_hierarchical_sum_boundary = false;
+bool WarpX::do_single_precision_comms = false;
+bool WarpX::do_single_precision_current_sum = false;
+bool WarpX::do_shared_memory_fields = false;
+int WarpX::fields_version = 0;
 
 IntVect WarpX::filter_npass_each_dir(1);
 
@@ -134,6 +143,7 @@ int WarpX::n_field_gather_buffer = -1;
 int WarpX::n_current_deposition_buffer = -1;
 
 int WarpX::do_nodal = false;
+bool WarpX::do_vectorized_deposition = false;
 
 #ifdef AMREX_USE_GPU
 bool WarpX::do_device_synchronize_before_profile = true;
@@ -245,6 +255,7 @@ WarpX::WarpX ()
     load_balance_efficiency.resize(nlevs_max);
 
     m_field_factory.resize(nlevs_max);
+    m_field_arena.resize(nlevs_max);
 
     if (em_solver_medium == MediumForEM::Macroscopic) {
         // create object for macroscopic solver
@@ -304,6 +315,12 @@ WarpX::WarpX ()
         spectral_solver_fp.resize(nlevs_max);
         spectral_solver_cp.resize(nlevs_max);
     }
+#endif
+#if defined(WARPX_USE_PSATD) && !defined(WARPX_DIM_RZ)
+    if (do_electrostatic != ElectrostaticSolverAlgo::None &&
+        poisson_solver_id == PoissonSolverAlgo::FFT) {
+        m_poisson_fft_solver = std::make_unique<SpectralPoissonSolver>(Geom(0));
+    }
 #endif
     if (WarpX::maxwell_solver_id != MaxwellSolverAlgo::PSATD) {
         m_fdtd_solver_fp.resize(nlevs_max);
@@ -348,6 +365,7 @@ WarpX::ReadParameters ()
         ParmParse pp("amr");// Traditionally, these have prefix, amr.
 
         pp.query("restart", restart_chkfile);
+        pp.query("regrid_on_restart", regrid_on_restart);
     }
 
     {
@@ -398,12 +416,29 @@ WarpX::ReadParameters ()
         pp.query("do_subcycling", do_subcycling);
         pp.query("use_hybrid_QED", use_hybrid_QED);
         pp.query("safe_guard_cells", safe_guard_cells);
+        pp.query("do_hierarchical_sum_boundary", do_hierarchical_sum_boundary);
+        pp.query("do_single_precision_comms", do_single_precision_comms);
+        pp.query("do_single_precision_current_sum", do_single_precision_current_sum);
+        pp.query("do_shared_memory_fields", do_shared_memory_fields);
+#ifdef AMREX_USE_GPU
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!do_shared_memory_fields,
+            "warpx.do_shared_memory_fields is not supported on GPU");
+#endif
+        std::vector<std::string> plugins;
+        pp.queryarr("plugins", plugins);
+        WarpXPlugins::Load(plugins);
+
         std::vector<std::string> override_sync_intervals_string_vec = {"1"};
         pp.queryarr("override_sync_intervals", override_sync_intervals_string_vec);
         override_sync_intervals = IntervalsParser(override_sync_intervals_string_vec);
 
-        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(do_subcycling != 1 || max_level <= 1,
-                                         "Subcycling method 1 only works for 2 levels.");
+        // The time step of each level is the one of the next finer level,
+        // times the refinement ratio (see ComputeDt)
+        for (int lev = 0; lev < max_level; ++lev) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                do_subcycling != 1 || refRatio(lev) == IntVect(refRatio(lev)[0]),
+                "Subcycling requires the same refinement ratio in all directions.");
+        }
 
         ReadBoostedFrameParameters(gamma_boost, beta_boost, boost_direction);
 
@@ -485,6 +520,16 @@ WarpX::ReadParameters ()
         }
 
         do_electrostatic = GetAlgorithmInteger(pp, "do_electrostatic");
+        poisson_solver_id = GetAlgorithmInteger(pp, "poisson_solver");
+
+        if (poisson_solver_id == PoissonSolverAlgo::FFT) {
+#if !defined(WARPX_USE_PSATD) || defined(WARPX_DIM_RZ)
+            amrex::Abort("warpx.poisson_solver = fft is not supported because WarpX was built "
+                         "without spectral solvers, or in RZ geometry");
+#endif
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(maxLevel() == 0,
+                "warpx.poisson_solver = fft is not implemented with mesh refinement");
+        }
 
         if (do_electrostatic == ElectrostaticSolverAlgo::LabFrame) {
             queryWithParser(pp, "self_fields_required_precision", self_fields_required_precision);
@@ -531,13 +576,25 @@ WarpX::ReadParameters ()
         pp.query("do_dive_cleaning", do_dive_cleaning);
         pp.query("n_field_gather_buffer", n_field_gather_buffer);
         pp.query("n_current_deposition_buffer", n_current_deposition_buffer);
+
+        pp.query("do_vectorized_deposition", do_vectorized_deposition);
+#if defined(AMREX_USE_GPU) || defined(WARPX_DIM_RZ)
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!do_vectorized_deposition,
+            "warpx.do_vectorized_deposition is only available on CPU, in Cartesian geometry");
+#endif
+
 #ifdef AMREX_USE_GPU
         std::vector<std::string>sort_intervals_string_vec = {"4"};
 #else
-        std::vector<std::string> sort_intervals_string_vec = {"-1"};
+        // The vectorized deposition is most efficient when the particles are sorted by cell
+        std::vector<std::string> sort_intervals_string_vec = {do_vectorized_deposition ? "4" : "-1"};
 #endif
+        // With the adaptive sorting, the locality of the tiles is checked at every step by default
+        queryWithParser(pp, "sort_locality_threshold", sort_locality_threshold);
+        if (sort_locality_threshold >= 0._rt) sort_intervals_string_vec = {"1"};
         pp.queryarr("sort_intervals", sort_intervals_string_vec);
         sort_intervals = IntervalsParser(sort_intervals_string_vec);
+        pp.query("sort_space_filling_curve", sort_space_filling_curve);
 
         Vector<int> vect_sort_bin_size(AMREX_SPACEDIM,1);
         bool sort_bin_size_is_specified = pp.queryarr("sort_bin_size", vect_sort_bin_size);
@@ -608,10 +665,30 @@ WarpX::ReadParameters ()
 
         if (maxLevel() > 0) {
             Vector<Real> lo, hi;
-            pp.getarr("fine_tag_lo", lo);
-            pp.getarr("fine_tag_hi", hi);
-            fine_tag_lo = RealVect{lo};
-            fine_tag_hi = RealVect{hi};
+            tag_static_box = pp.queryarr("fine_tag_lo", lo);
+            if (tag_static_box) {
+                pp.getarr("fine_tag_hi", hi);
+                fine_tag_lo = RealVect{lo};
+                fine_tag_hi = RealVect{hi};
+            }
+
+            // Dynamic criteria, evaluated at each regrid (warpx.regrid_int)
+            pp.query("tag_particles_per_cell", tag_particles_per_cell);
+            queryWithParser(pp, "tag_rho_threshold", tag_rho_threshold);
+            queryWithParser(pp, "tag_field_gradient_threshold", tag_field_gradient_threshold);
+            if (pp.contains("tag_function(x,y,z,t)")) {
+                std::string str_tag_function;
+                Store_parserString(pp, "tag_function(x,y,z,t)", str_tag_function);
+                tag_function_parser = std::make_unique<ParserWrapper<4>>(
+                    makeParser(str_tag_function, {"x","y","z","t"}));
+            }
+
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                tag_static_box || tag_particles_per_cell > 0 || tag_rho_threshold > 0.
+                || tag_field_gradient_threshold > 0. || tag_function_parser,
+                "With mesh refinement, warpx.fine_tag_lo/fine_tag_hi or a dynamic tagging criterion "
+                "(warpx.tag_particles_per_cell, warpx.tag_rho_threshold, "
+                "warpx.tag_field_gradient_threshold, warpx.tag_function(x,y,z,t)) must be set");
         }
 
         pp.query("do_dynamic_scheduling", do_dynamic_scheduling);
@@ -746,6 +823,20 @@ WarpX::ReadParameters ()
     {
         ParmParse pp("psatd");
         pp.query("periodic_single_box_fft", fft_periodic_single_box);
+        pp.query("distributed_fft", fft_distributed);
+#ifndef WARPX_USE_FFTW_MPI
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!fft_distributed,
+            "psatd.distributed_fft requires WarpX to be compiled with MPI and FFTW (CPU)");
+#endif
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!(fft_distributed && fft_periodic_single_box),
+            "psatd.distributed_fft and psatd.periodic_single_box_fft cannot be used together");
+        pp.query("distributed_hankel", hankel_distributed);
+#ifndef WARPX_DIM_RZ
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!hankel_distributed,
+            "psatd.distributed_hankel can only be used in RZ geometry");
+#endif
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!(hankel_distributed && fft_periodic_single_box),
+            "psatd.distributed_hankel and psatd.periodic_single_box_fft cannot be used together");
         pp.query("fftw_plan_measure", fftw_plan_measure);
 
         std::string nox_str;
@@ -773,10 +864,10 @@ WarpX::ReadParameters ()
         }
 
 
-        if (!fft_periodic_single_box) {
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nox_fft > 0, "PSATD order must be finite unless psatd.periodic_single_box_fft is used");
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(noy_fft > 0, "PSATD order must be finite unless psatd.periodic_single_box_fft is used");
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(noz_fft > 0, "PSATD order must be finite unless psatd.periodic_single_box_fft is used");
+        if (!fft_periodic_single_box && !fft_distributed) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nox_fft > 0, "PSATD order must be finite unless psatd.periodic_single_box_fft or psatd.distributed_fft is used");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(noy_fft > 0, "PSATD order must be finite unless psatd.periodic_single_box_fft or psatd.distributed_fft is used");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(noz_fft > 0, "PSATD order must be finite unless psatd.periodic_single_box_fft or psatd.distributed_fft is used");
         }
 
         pp.query("current_correction", current_correction);
@@ -813,6 +904,8 @@ WarpX::ReadParameters ()
         // Overwrite update_with_rho with value set in input file
         pp.query("update_with_rho", update_with_rho);
 
+        pp.query("on_the_fly_coefficients", psatd_on_the_fly_coefficients);
+
         if (m_v_comoving[0] != 0. || m_v_comoving[1] != 0. || m_v_comoving[2] != 0.) {
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(update_with_rho,
                 "psatd.update_with_rho must be equal to 1 for comoving PSATD");
@@ -968,6 +1061,8 @@ WarpX::MakeNewLevelFromScratch (int lev, Real time, const BoxArray& new_grids,
 void
 WarpX::ClearLevel (int lev)
 {
+    ++fields_version;
+
     for (int i = 0; i < 3; ++i) {
         Efield_aux[lev][i].reset();
         Bfield_aux[lev][i].reset();
@@ -986,6 +1081,8 @@ WarpX::ClearLevel (int lev)
         Bfield_cax[lev][i].reset();
         current_buf[lev][i].reset();
     }
+    // After the fields that it contains
+    m_field_arena[lev].reset();
 
     charge_buf[lev].reset();
 
@@ -1066,6 +1163,8 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
                       const IntVect& ngE, const IntVect& ngJ, const IntVect& ngRho,
                       const IntVect& ngF, const IntVect& ngextra, const bool aux_is_nodal)
 {
+    ++fields_version;
+
     // Declare nodal flags
     IntVect Ex_nodal_flag, Ey_nodal_flag, Ez_nodal_flag;
     IntVect Bx_nodal_flag, By_nodal_flag, Bz_nodal_flag;
@@ -1146,13 +1245,26 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
     //
     std::array<Real,3> dx = CellSize(lev);
 
-    Bfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Bx_nodal_flag),dm,ncomps,ngE+ngextra,tag("Bfield_fp[x]"));
-    Bfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,By_nodal_flag),dm,ncomps,ngE+ngextra,tag("Bfield_fp[y]"));
-    Bfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Bz_nodal_flag),dm,ncomps,ngE+ngextra,tag("Bfield_fp[z]"));
+    if (do_shared_memory_fields) {
+        std::size_t nbytes = 0;
+        for (const IntVect& nodal_flag : {Bx_nodal_flag, By_nodal_flag, Bz_nodal_flag,
+                                          Ex_nodal_flag, Ey_nodal_flag, Ez_nodal_flag}) {
+            nbytes += SharedMemoryArena::BytesNeeded(amrex::convert(ba,nodal_flag), dm, ncomps, ngE+ngextra);
+        }
+        m_field_arena[lev] = std::make_unique<SharedMemoryArena>(nbytes);
+    }
+    // Without warpx.do_shared_memory_fields, the arena is nullptr, i.e. the default arena
+    auto const shared_tag = [&tag, arena = m_field_arena[lev].get()]( std::string tagname ) {
+        return tag(std::move(tagname)).SetArena(arena);
+    };
+
+    Bfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Bx_nodal_flag),dm,ncomps,ngE+ngextra,shared_tag("Bfield_fp[x]"));
+    Bfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,By_nodal_flag),dm,ncomps,ngE+ngextra,shared_tag("Bfield_fp[y]"));
+    Bfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Bz_nodal_flag),dm,ncomps,ngE+ngextra,shared_tag("Bfield_fp[z]"));
 
-    Efield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Ex_nodal_flag),dm,ncomps,ngE+ngextra,tag("Efield_fp[x]"));
-    Efield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Ey_nodal_flag),dm,ncomps,ngE+ngextra,tag("Efield_fp[y]"));
-    Efield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Ez_nodal_flag),dm,ncomps,ngE+ngextra,tag("Efield_fp[z]"));
+    Efield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Ex_nodal_flag),dm,ncomps,ngE+ngextra,shared_tag("Efield_fp[x]"));
+    Efield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Ey_nodal_flag),dm,ncomps,ngE+ngextra,shared_tag("Efield_fp[y]"));
+    Efield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Ez_nodal_flag),dm,ncomps,ngE+ngextra,shared_tag("Efield_fp[z]"));
 
     current_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,jx_nodal_flag),dm,ncomps,ngJ,tag("current_fp[x]"));
     current_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,jy_nodal_flag),dm,ncomps,ngJ,tag("current_fp[y]"));
@@ -1183,7 +1295,7 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
         phi_fp[lev] = std::make_unique<MultiFab>(amrex::convert(ba,phi_nodal_flag),dm,ncomps,ngPhi,tag("phi_fp"));
     }
 
-    if (do_subcycling == 1 && lev == 0)
+    if (do_subcycling == 1 && lev < max_level)
     {
         current_store[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,jx_nodal_flag),dm,ncomps,ngJ,tag("current_store[x]"));
         current_store[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,jy_nodal_flag),dm,ncomps,ngJ,tag("current_store[y]"));
@@ -1223,6 +1335,22 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
                 "The option `psatd.periodic_single_box_fft` can only be used for a periodic domain, decomposed in a single box");
 #   endif
         }
+        // Check whether the option distributed FFT is valid here
+        if (fft_distributed) {
+#   ifdef WARPX_DIM_RZ
+            amrex::Abort("The option `psatd.distributed_fft` is not implemented in RZ geometry");
+#   else
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                geom[0].isAllPeriodic()        // domain is periodic in all directions
+                && maxLevel() == 0,            // no mesh refinement
+                "The option `psatd.distributed_fft` can only be used for a periodic domain, without mesh refinement");
+#   endif
+        }
+        // Check whether the option distributed Hankel transforms is valid here
+        if (hankel_distributed) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(maxLevel() == 0,
+                "The option `psatd.distributed_hankel` can only be used without mesh refinement");
+        }
         // Get the cell-centered box
         BoxArray realspace_ba = ba;  // Copy box
         realspace_ba.enclosedCells(); // Make it cell-centered
@@ -1232,18 +1360,20 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
             realspace_ba.grow(1, ngE[1]); // add guard cells only in z
         }
         spectral_solver_fp[lev] = std::make_unique<SpectralSolverRZ>( realspace_ba, dm,
-            n_rz_azimuthal_modes, noz_fft, do_nodal, m_v_galilean, dx_vect, dt[lev], lev, update_with_rho );
+            n_rz_azimuthal_modes, noz_fft, do_nodal, m_v_galilean, dx_vect, dt[lev], lev, update_with_rho,
+            hankel_distributed );
         if (use_kspace_filter) {
             spectral_solver_fp[lev]->InitFilter(filter_npass_each_dir, use_filter_compensation);
         }
 #   else
-        if ( fft_periodic_single_box == false ) {
+        if ( fft_periodic_single_box == false && fft_distributed == false ) {
             realspace_ba.grow(ngE); // add guard cells
         }
         bool const pml_flag_false = false;
         spectral_solver_fp[lev] = std::make_unique<SpectralSolver>( realspace_ba, dm,
             nox_fft, noy_fft, noz_fft, do_nodal, m_v_galilean, m_v_comoving, dx_vect, dt[lev],
-            pml_flag_false, fft_periodic_single_box, update_with_rho, fft_do_time_averaging );
+            pml_flag_false, fft_periodic_single_box, update_with_rho, fft_do_time_averaging,
+            psatd_on_the_fly_coefficients, fft_distributed );
 #   endif
 #endif
     } // MaxwellSolverAlgo::PSATD
@@ -1369,7 +1499,8 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
             bool const pml_flag_false = false;
             spectral_solver_cp[lev] = std::make_unique<SpectralSolver>( c_realspace_ba, dm,
                 nox_fft, noy_fft, noz_fft, do_nodal, m_v_galilean, m_v_comoving, cdx_vect, dt[lev],
-                pml_flag_false, fft_periodic_single_box, update_with_rho, fft_do_time_averaging );
+                pml_flag_false, fft_periodic_single_box, update_with_rho, fft_do_time_averaging,
+                psatd_on_the_fly_coefficients );
 #   endif
 #endif
         } // MaxwellSolverAlgo::PSATD
@@ -1733,7 +1864,8 @@ WarpX::StoreCurrent (int lev)
     for (int idim = 0; idim < 3; ++idim) {
         if (current_store[lev][idim]) {
             MultiFab::Copy(*current_store[lev][idim], *current_fp[lev][idim],
-                           0, 0, 1, current_store[lev][idim]->nGrowVect());
+                           0, 0, current_store[lev][idim]->nComp(),
+                           current_store[lev][idim]->nGrowVect());
         }
     }
 }
@@ -1741,9 +1873,13 @@ WarpX::StoreCurrent (int lev)
 void
 WarpX::RestoreCurrent (int lev)
 {
+    // Copy (instead of swapping) so that the stored current can be restored
+    // at each substep of the finer level
     for (int idim = 0; idim < 3; ++idim) {
         if (current_store[lev][idim]) {
-            std::swap(current_fp[lev][idim], current_store[lev][idim]);
+            MultiFab::Copy(*current_fp[lev][idim], *current_store[lev][idim],
+                           0, 0, current_store[lev][idim]->nComp(),
+                           current_store[lev][idim]->nGrowVect());
         }
     }
 }
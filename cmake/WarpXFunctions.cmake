@@ -161,6 +161,14 @@ function(set_warpx_binary_name)
             set_property(TARGET ${tgt} APPEND_STRING PROPERTY OUTPUT_NAME ".SP")
         endif()
 
+        if(NOT WarpX_PARTICLE_PRECISION STREQUAL WarpX_PRECISION)
+            if(WarpX_PARTICLE_PRECISION STREQUAL "DOUBLE")
+                set_property(TARGET ${tgt} APPEND_STRING PROPERTY OUTPUT_NAME ".pDP")
+            else()
+                set_property(TARGET ${tgt} APPEND_STRING PROPERTY OUTPUT_NAME ".pSP")
+            endif()
+        endif()
+
         if(WarpX_ASCENT)
             set_property(TARGET ${tgt} APPEND_STRING PROPERTY OUTPUT_NAME ".ASCENT")
         endif()
@@ -290,6 +298,7 @@ function(warpx_print_summary)
     message("    Parser depth: ${WarpX_PARSER_DEPTH}")
     message("    PSATD: ${WarpX_PSATD}")
     message("    PRECISION: ${WarpX_PRECISION}")
+    message("    PARTICLE PRECISION: ${WarpX_PARTICLE_PRECISION}")
     message("    OPENPMD: ${WarpX_OPENPMD}")
     message("    QED: ${WarpX_QED}")
     message("    QED table generation: ${WarpX_QED_TABLE_GEN}")
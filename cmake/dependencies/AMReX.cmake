@@ -55,9 +55,12 @@ macro(find_amrex)
 
         if(WarpX_PRECISION STREQUAL "DOUBLE")
             set(AMReX_PRECISION "DOUBLE" CACHE INTERNAL "")
-            set(AMReX_PRECISION_PARTICLES "DOUBLE" CACHE INTERNAL "")
         else()
             set(AMReX_PRECISION "SINGLE" CACHE INTERNAL "")
+        endif()
+        if(WarpX_PARTICLE_PRECISION STREQUAL "DOUBLE")
+            set(AMReX_PRECISION_PARTICLES "DOUBLE" CACHE INTERNAL "")
+        else()
             set(AMReX_PRECISION_PARTICLES "SINGLE" CACHE INTERNAL "")
         endif()
 
@@ -169,7 +172,7 @@ macro(find_amrex)
         else()
             set(COMPONENT_PIC)
         endif()
-        set(COMPONENT_PRECISION ${WarpX_PRECISION} P${WarpX_PRECISION})
+        set(COMPONENT_PRECISION ${WarpX_PRECISION} P${WarpX_PARTICLE_PRECISION})
 
         find_package(AMReX 21.02 CONFIG REQUIRED COMPONENTS ${COMPONENT_ASCENT} ${COMPONENT_DIM} ${COMPONENT_EB} PARTICLES ${COMPONENT_PIC} ${COMPONENT_PRECISION} TINYP LSOLVERS)
         message(STATUS "AMReX: Found version '${AMReX_VERSION}'")